@@ -0,0 +1,297 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Adaptive network transmit and relay retransmit counts. Static counts are chosen for the
+ * worst corner of the building and waste air time everywhere else. Every ADAPTIVE_TX_INTERVAL
+ * the node computes how many copies of each new network PDU it heard from the hits and misses
+ * of the network message cache. Few copies mean a sparse neighbourhood where a lost
+ * advertisement is not covered by another relay, so the count goes up by one. Many copies
+ * with no lost acknowledgements mean a dense, healthy neighbourhood, so the count goes down
+ * by one. Lost acknowledgements of segmented messages raise the count regardless of the
+ * density.
+ *
+ * The network transmit and relay retransmit counts configured by the provisioner (Config Network
+ * Transmit Set and Config Relay Set) are the ceilings, ADAPTIVE_TX_MAX from the makefile caps
+ * them. The node starts at the ceilings and lowers both counts by the same number of steps,
+ * never below ADAPTIVE_TX_MIN, a configured count at or below ADAPTIVE_TX_MIN is kept. A count
+ * other than the one the node set was changed by the provisioner and becomes the new ceiling.
+ * The configured intervals are not changed.
+ *
+ * The prebuilt mesh core does not let the application read or write the counts. The module is
+ * written against an assumed extension of the core API, wiced_bt_mesh_core_get/set_network_transmit_count,
+ * wiced_bt_mesh_core_get/set_relay_retransmit_count and wiced_bt_mesh_core_register_segmented_tx_cb,
+ * and on the network message cache hook of net_cache.c.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "net_cache.h"
+#include "adaptive_tx.h"
+
+#if defined(ADAPTIVE_TX) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define ADAPTIVE_TX_INTERVAL            30          // seconds between adjustments
+#define ADAPTIVE_TX_MIN_SAMPLES         20          // new PDUs in the interval needed for a density estimate
+#define ADAPTIVE_TX_SPARSE              (4 * 16)    // fewer copies per new PDU, 1/16 units, increase the count
+#define ADAPTIVE_TX_DENSE               (12 * 16)   // more copies per new PDU, 1/16 units, decrease the count
+#define ADAPTIVE_TX_MIN_ACK_SAMPLES     4           // segmented messages in the interval needed for the loss rate
+#define ADAPTIVE_TX_MAX_LOSS            8           // lost acknowledgements above 1/8 increase the count
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    wiced_timer_t   timer;
+    wiced_bool_t    timer_initialized;
+    uint8_t         steps;                      // steps below the ceilings
+    uint8_t         net_configured;             // network transmit count of the provisioner
+    uint8_t         relay_configured;           // relay retransmit count of the provisioner
+    uint8_t         net_count;                  // network transmit count set by the node, 0xFF if none
+    uint8_t         relay_count;                // relay retransmit count set by the node, 0xFF if none
+    uint16_t        copies;                     // copies heard per new PDU, 1/16 units, 0 if not known
+    uint32_t        hits;                       // network message cache counters at the start of the interval
+    uint32_t        misses;
+    uint16_t        acked;                      // segmented messages in the current interval
+    uint16_t        lost;
+    uint32_t        acked_total;
+    uint32_t        lost_total;
+    uint16_t        increases;
+    uint16_t        decreases;
+} adaptive_tx_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static void adaptive_tx_timer_cb(TIMER_PARAM_TYPE arg);
+static void adaptive_tx_read_configured(void);
+static uint8_t adaptive_tx_lowered(uint8_t configured);
+static void adaptive_tx_apply(void);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static adaptive_tx_state_t adaptive_tx = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Start at the configured counts and start the periodic adjustment
+ */
+void adaptive_tx_init(void)
+{
+    adaptive_tx.steps       = 0;
+    adaptive_tx.net_count   = 0xFF;
+    adaptive_tx.relay_count = 0xFF;
+    adaptive_tx_read_configured();
+    adaptive_tx_apply();
+    net_cache_get_counters(&adaptive_tx.hits, &adaptive_tx.misses);
+
+    if (!adaptive_tx.timer_initialized)
+    {
+        wiced_init_timer(&adaptive_tx.timer, adaptive_tx_timer_cb, 0, WICED_SECONDS_PERIODIC_TIMER);
+        adaptive_tx.timer_initialized = WICED_TRUE;
+    }
+    wiced_stop_timer(&adaptive_tx.timer);
+    wiced_start_timer(&adaptive_tx.timer, ADAPTIVE_TX_INTERVAL);
+
+    wiced_bt_mesh_core_register_segmented_tx_cb(adaptive_tx_ack_result);
+}
+
+/*
+ * Transmission of a segmented message completed, acked is WICED_FALSE if the destination did
+ * not acknowledge all segments
+ */
+void adaptive_tx_ack_result(wiced_bool_t acked)
+{
+    if (acked)
+    {
+        adaptive_tx.acked++;
+        adaptive_tx.acked_total++;
+    }
+    else
+    {
+        adaptive_tx.lost++;
+        adaptive_tx.lost_total++;
+    }
+}
+
+/*
+ * Read the counts from the mesh core. A count other than the one the node set was configured
+ * by the provisioner since.
+ */
+static void adaptive_tx_read_configured(void)
+{
+    uint8_t net   = wiced_bt_mesh_core_get_network_transmit_count();
+    uint8_t relay = wiced_bt_mesh_core_get_relay_retransmit_count();
+
+    if (net != adaptive_tx.net_count)
+        adaptive_tx.net_configured = net;
+    if (relay != adaptive_tx.relay_count)
+        adaptive_tx.relay_configured = relay;
+}
+
+/*
+ * Returns the configured count, capped by ADAPTIVE_TX_MAX and lowered by the current steps
+ */
+static uint8_t adaptive_tx_lowered(uint8_t configured)
+{
+    uint8_t ceiling = (configured > ADAPTIVE_TX_MAX) ? ADAPTIVE_TX_MAX : configured;
+
+    if (ceiling <= ADAPTIVE_TX_MIN)
+        return ceiling;
+    return (ceiling - ADAPTIVE_TX_MIN > adaptive_tx.steps) ? (uint8_t)(ceiling - adaptive_tx.steps) : ADAPTIVE_TX_MIN;
+}
+
+/*
+ * Set the network transmit and relay retransmit counts in the mesh core
+ */
+static void adaptive_tx_apply(void)
+{
+    uint8_t net   = adaptive_tx_lowered(adaptive_tx.net_configured);
+    uint8_t relay = adaptive_tx_lowered(adaptive_tx.relay_configured);
+
+    if (net != adaptive_tx.net_count)
+    {
+        adaptive_tx.net_count = net;
+        wiced_bt_mesh_core_set_network_transmit_count(net);
+    }
+    if (relay != adaptive_tx.relay_count)
+    {
+        adaptive_tx.relay_count = relay;
+        wiced_bt_mesh_core_set_relay_retransmit_count(relay);
+    }
+}
+
+/*
+ * Update the density estimate and the loss rate and adjust the count at the end of the interval
+ */
+static void adaptive_tx_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    uint32_t     hits, misses, new_pdus;
+    wiced_bool_t lossy = WICED_FALSE;
+    wiced_bool_t healthy = WICED_TRUE;
+
+    adaptive_tx_read_configured();
+    net_cache_get_counters(&hits, &misses);
+    new_pdus = misses - adaptive_tx.misses;
+
+    // Counters cleared over HCI, start a new interval
+    if ((hits < adaptive_tx.hits) || (misses < adaptive_tx.misses))
+        new_pdus = 0;
+
+    if (new_pdus >= ADAPTIVE_TX_MIN_SAMPLES)
+    {
+        uint32_t copies = (new_pdus + hits - adaptive_tx.hits) * 16 / new_pdus;
+
+        adaptive_tx.copies = (adaptive_tx.copies == 0) ? (uint16_t)copies : (uint16_t)((adaptive_tx.copies + copies) / 2);
+        adaptive_tx.hits   = hits;
+        adaptive_tx.misses = misses;
+    }
+    else if (new_pdus == 0)
+    {
+        adaptive_tx.hits   = hits;
+        adaptive_tx.misses = misses;
+    }
+
+    if (adaptive_tx.lost != 0)
+        healthy = WICED_FALSE;
+    if ((adaptive_tx.acked + adaptive_tx.lost >= ADAPTIVE_TX_MIN_ACK_SAMPLES) &&
+        (adaptive_tx.lost * ADAPTIVE_TX_MAX_LOSS > adaptive_tx.acked + adaptive_tx.lost))
+        lossy = WICED_TRUE;
+    adaptive_tx.acked = 0;
+    adaptive_tx.lost  = 0;
+
+    if ((lossy || ((adaptive_tx.copies != 0) && (adaptive_tx.copies < ADAPTIVE_TX_SPARSE))) && (adaptive_tx.steps != 0))
+    {
+        adaptive_tx.steps--;
+        adaptive_tx.increases++;
+    }
+    else if (healthy && (adaptive_tx.copies > ADAPTIVE_TX_DENSE) &&
+             ((adaptive_tx_lowered(adaptive_tx.net_configured) > ADAPTIVE_TX_MIN) || (adaptive_tx_lowered(adaptive_tx.relay_configured) > ADAPTIVE_TX_MIN)))
+    {
+        adaptive_tx.steps++;
+        adaptive_tx.decreases++;
+    }
+    // Also without a step, the provisioner may have changed a ceiling
+    adaptive_tx_apply();
+
+    WICED_BT_TRACE("adaptive tx copies:%d/16 net:%d relay:%d\n", adaptive_tx.copies, adaptive_tx.net_count, adaptive_tx.relay_count);
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t adaptive_tx_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+
+    UINT16_TO_STREAM(p, adaptive_tx.copies);
+    UINT8_TO_STREAM(p, adaptive_tx.net_count);
+    UINT8_TO_STREAM(p, adaptive_tx.relay_count);
+    UINT8_TO_STREAM(p, ADAPTIVE_TX_MIN);
+    UINT8_TO_STREAM(p, ADAPTIVE_TX_MAX);
+    UINT8_TO_STREAM(p, adaptive_tx.net_configured);
+    UINT8_TO_STREAM(p, adaptive_tx.relay_configured);
+    UINT32_TO_STREAM(p, adaptive_tx.acked_total);
+    UINT32_TO_STREAM(p, adaptive_tx.lost_total);
+    UINT16_TO_STREAM(p, adaptive_tx.increases);
+    UINT16_TO_STREAM(p, adaptive_tx.decreases);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void adaptive_tx_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[ADAPTIVE_TX_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_ADAPTIVE_TX_STATS, buffer, adaptive_tx_serialize_stats(buffer));
+#endif
+}
+
+#endif // ADAPTIVE_TX && !LOW_POWER_NODE
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Adaptive network transmit and relay retransmit API definition
+ */
+
+#ifndef __ADAPTIVE_TX__H
+#define __ADAPTIVE_TX__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   copies heard per new PDU in 1/16 units (2), current network transmit and relay retransmit
+ *   counts (1 each), ADAPTIVE_TX_MIN (1), ADAPTIVE_TX_MAX (1), network transmit and relay
+ *   retransmit counts configured by the provisioner (1 each), segmented messages acknowledged
+ *   (4) and lost (4), count increases (2) and decreases (2)
+ */
+#define ADAPTIVE_TX_STATS_LEN               (2 + 1 + 1 + 1 + 1 + 1 + 1 + 4 + 4 + 2 + 2)
+
+/*
+ * Start at the configured counts and start the periodic adjustment
+ */
+void adaptive_tx_init(void);
+
+/*
+ * Transmission of a segmented message completed, acked is WICED_FALSE if the destination did
+ * not acknowledge all segments
+ */
+void adaptive_tx_ack_result(wiced_bool_t acked);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t adaptive_tx_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void adaptive_tx_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
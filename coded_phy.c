@@ -0,0 +1,254 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * LE Coded PHY on the LPN-friend link. An LPN at the edge of the friend's coverage loses many
+ * Polls and responses, and every retry costs a Poll and a receive window. Coded PHY S8 gains
+ * about 9 dB of sensitivity for 8 times the air time, which costs less than the retries on a
+ * weak link. The friend receives Polls on both PHYs and answers on the PHY of the Poll.
+ *
+ * The LPN keeps moving averages of the share of poll cycles answered at the first attempt and
+ * of the RSSI of the friend responses. It moves to Coded PHY when the success rate drops below
+ * CODED_PHY_ENTER_SUCCESS or the RSSI below CODED_PHY_ENTER_RSSI, and back to 1M when both are
+ * above the exit thresholds. The PHY is kept for CODED_PHY_HOLD_CYCLES poll cycles after a
+ * change. A friend which has not answered a single Poll on Coded PHY since the switch and
+ * leaves CODED_PHY_MAX_FAILED poll cycles unanswered does not support it, the LPN stays on 1M
+ * for CODED_PHY_RETRY seconds. Once the friend has answered on Coded PHY, failed poll cycles
+ * are taken as a weak link and the LPN stays on Coded PHY.
+ *
+ * The prebuilt mesh core sends and receives the friendship PDUs on 1M only. The module is
+ * written against an assumed extension of the core API, wiced_bt_mesh_core_lpn_set_phy on the
+ * LPN and wiced_bt_mesh_core_friend_coded_phy_enable on the friend, and on the LPN poll cycle
+ * events (wiced_bt_mesh_core_lpn_register_event_cb), and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "coded_phy.h"
+
+#ifdef CODED_PHY
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define CODED_PHY_ENTER_SUCCESS         192         // 1/256 units, first attempt success below 75% moves to Coded PHY
+#define CODED_PHY_EXIT_SUCCESS          230         // 1/256 units, 90% needed to move back to 1M
+#define CODED_PHY_ENTER_RSSI            (-91)       // response RSSI below moves to Coded PHY, 4 dB above 1M sensitivity
+#define CODED_PHY_EXIT_RSSI             (-85)       // response RSSI above moves back to 1M
+#define CODED_PHY_HOLD_CYCLES           8           // poll cycles after a change before the next one
+#define CODED_PHY_MAX_FAILED            3           // failed poll cycles on Coded PHY before falling back to 1M
+#define CODED_PHY_RETRY                 3600        // seconds before Coded PHY is tried again after a fallback
+#define CODED_PHY_SUCCESS_FULL          256
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t         phy;                        // WICED_BT_MESH_CORE_PHY_xxx
+    uint16_t        success;                    // first attempt success, 1/256 units
+    int8_t          rssi;                       // response RSSI, 0 if no response received yet
+    uint8_t         hold;                       // poll cycles before the PHY can change again
+    uint8_t         failed;                     // consecutive failed poll cycles on Coded PHY
+    wiced_bool_t    coded_answered;             // friend answered on Coded PHY since the switch
+    uint32_t        coded_disabled_until;       // seconds, 0 if Coded PHY can be used
+    uint32_t        cycles_1m;
+    uint32_t        cycles_coded;
+    uint16_t        to_coded;
+    uint16_t        to_1m;
+    uint16_t        fallbacks;
+} coded_phy_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static void coded_phy_cycle_done(wiced_bool_t success);
+static void coded_phy_set(uint8_t phy);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static coded_phy_state_t coded_phy = { 0 };
+#endif
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * LPN starts on 1M, the friend enables Coded PHY reception
+ */
+void coded_phy_init(void)
+{
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    coded_phy.success = CODED_PHY_SUCCESS_FULL;
+    coded_phy.rssi    = 0;
+    coded_phy.hold    = 0;
+    coded_phy.failed  = 0;
+    coded_phy_set(WICED_BT_MESH_CORE_PHY_1M);
+#else
+    wiced_bt_mesh_core_friend_coded_phy_enable(WICED_TRUE);
+#endif
+}
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+/*
+ * Poll cycle event of the mesh core
+ */
+void coded_phy_lpn_event(wiced_bt_mesh_core_lpn_event_t *p_event)
+{
+    switch (p_event->type)
+    {
+    case WICED_BT_MESH_CORE_LPN_EVENT_RESPONSE:
+        coded_phy.rssi   = (coded_phy.rssi == 0) ? p_event->rssi : (int8_t)((7 * coded_phy.rssi + p_event->rssi) / 8);
+        coded_phy.failed = 0;
+        if (coded_phy.phy == WICED_BT_MESH_CORE_PHY_CODED)
+            coded_phy.coded_answered = WICED_TRUE;
+        if (p_event->attempt == 0)
+            coded_phy_cycle_done(WICED_TRUE);
+        break;
+
+    case WICED_BT_MESH_CORE_LPN_EVENT_NO_RESPONSE:
+        if (p_event->attempt == 0)
+            coded_phy_cycle_done(WICED_FALSE);
+        break;
+
+    case WICED_BT_MESH_CORE_LPN_EVENT_POLL_FAILED:
+        // Friend which never answered on Coded PHY does not support it, after an answer it is a weak link
+        if ((coded_phy.phy == WICED_BT_MESH_CORE_PHY_CODED) && !coded_phy.coded_answered && (++coded_phy.failed >= CODED_PHY_MAX_FAILED))
+        {
+            WICED_BT_TRACE("coded phy fallback\n");
+            coded_phy.fallbacks++;
+            coded_phy.coded_disabled_until = (uint32_t)(clock_SystemTimeMicroseconds64() / 1000000) + CODED_PHY_RETRY;
+            coded_phy_set(WICED_BT_MESH_CORE_PHY_1M);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * First Poll of the cycle answered or not, select the PHY for the next cycles
+ */
+static void coded_phy_cycle_done(wiced_bool_t success)
+{
+    wiced_bool_t weak, strong;
+
+    if (coded_phy.phy == WICED_BT_MESH_CORE_PHY_CODED)
+        coded_phy.cycles_coded++;
+    else
+        coded_phy.cycles_1m++;
+
+    coded_phy.success = (uint16_t)((7 * coded_phy.success + (success ? CODED_PHY_SUCCESS_FULL : 0)) / 8);
+
+    if (coded_phy.hold != 0)
+    {
+        coded_phy.hold--;
+        return;
+    }
+
+    weak   = (coded_phy.rssi != 0) && (coded_phy.rssi < CODED_PHY_ENTER_RSSI);
+    strong = (coded_phy.rssi != 0) && (coded_phy.rssi > CODED_PHY_EXIT_RSSI);
+
+    if (coded_phy.phy == WICED_BT_MESH_CORE_PHY_1M)
+    {
+        if (((coded_phy.success < CODED_PHY_ENTER_SUCCESS) || weak) &&
+            ((uint32_t)(clock_SystemTimeMicroseconds64() / 1000000) >= coded_phy.coded_disabled_until))
+        {
+            coded_phy.to_coded++;
+            coded_phy_set(WICED_BT_MESH_CORE_PHY_CODED);
+        }
+    }
+    else if ((coded_phy.success >= CODED_PHY_EXIT_SUCCESS) && strong)
+    {
+        coded_phy.to_1m++;
+        coded_phy_set(WICED_BT_MESH_CORE_PHY_1M);
+    }
+}
+
+/*
+ * Change the PHY of the Polls, the success rate starts again on the new PHY
+ */
+static void coded_phy_set(uint8_t phy)
+{
+    WICED_BT_TRACE("coded phy set:%d success:%d/256 rssi:%d\n", phy, coded_phy.success, coded_phy.rssi);
+
+    coded_phy.phy     = phy;
+    coded_phy.success = CODED_PHY_SUCCESS_FULL;
+    coded_phy.hold    = CODED_PHY_HOLD_CYCLES;
+    coded_phy.failed  = 0;
+    coded_phy.coded_answered = WICED_FALSE;
+    wiced_bt_mesh_core_lpn_set_phy(phy);
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t coded_phy_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+
+    UINT8_TO_STREAM(p, coded_phy.phy);
+    UINT16_TO_STREAM(p, coded_phy.success);
+    UINT8_TO_STREAM(p, (uint8_t)coded_phy.rssi);
+    UINT32_TO_STREAM(p, coded_phy.cycles_1m);
+    UINT32_TO_STREAM(p, coded_phy.cycles_coded);
+    UINT16_TO_STREAM(p, coded_phy.to_coded);
+    UINT16_TO_STREAM(p, coded_phy.to_1m);
+    UINT16_TO_STREAM(p, coded_phy.fallbacks);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void coded_phy_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[CODED_PHY_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_CODED_PHY_STATS, buffer, coded_phy_serialize_stats(buffer));
+#endif
+}
+#endif // LOW_POWER_NODE
+
+#endif // CODED_PHY
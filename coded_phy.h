@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * LE Coded PHY on the LPN-friend link API definition
+ */
+
+#ifndef __CODED_PHY__H
+#define __CODED_PHY__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Serialized statistics of the LPN, little endian
+ *   PHY (1, 1 for 1M, 3 for Coded), first attempt success in 1/256 units (2), response RSSI
+ *   in dBm (1, signed), poll cycles on 1M (4) and on Coded PHY (4), changes to Coded PHY (2)
+ *   and to 1M (2), fallbacks because the friend did not answer on Coded PHY (2)
+ */
+#define CODED_PHY_STATS_LEN                 (1 + 2 + 1 + 4 + 4 + 2 + 2 + 2)
+
+/*
+ * LPN starts on 1M, the friend enables Coded PHY reception
+ */
+void coded_phy_init(void);
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+/*
+ * Poll cycle event of the mesh core
+ */
+void coded_phy_lpn_event(wiced_bt_mesh_core_lpn_event_t *p_event);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t coded_phy_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void coded_phy_hci_send(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,463 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Experiment cohorts of low power nodes. A site runs one experiment at a time, identified by
+ * COHORT_EXPERIMENT. Each node belongs to one of COHORT_NUM cohorts, assigned by the
+ * provisioner with the vendor model or, until it does, by a hash of the device address and the
+ * experiment, so that a new experiment shuffles the nodes again. Each cohort applies its own
+ * parameter set from cohort_params: early sleep after a response without more data, poll
+ * timeout and, with COHORT_TRANSMIT_COUNT, network transmit count of own messages. Cohort 0 is
+ * the control group and uses the build settings.
+ *
+ * The Network Transmit state belongs to the provisioner (Config Network Transmit Set). A cohort
+ * only lowers the configured count and restores it when the cohort has no count of its own, a
+ * count changed by the provisioner since becomes the configured count. The prebuilt mesh core
+ * does not let the application read or write the count, COHORT_TRANSMIT_COUNT is written against
+ * an assumed extension, wiced_bt_mesh_core_get_network_transmit_count and
+ * wiced_bt_mesh_core_set_network_transmit_count.
+ *
+ * The node counts poll cycles, awake and sleep time, received messages and the intervals
+ * between polls since the cohort was assigned. A message waits in the friend queue for the next
+ * poll, so the intervals give the delivery latency of the cohort. The record is tagged with the
+ * experiment and the cohort, it is read over the vendor model or WICED HCI, and it is saved in
+ * NVRAM before HID-off, which resets the RAM.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_bt_dev.h"
+#include "wiced_hal_nvram.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "low_power_led_vendor.h"
+#include "nvram_wear.h"
+#include "cohort.h"
+
+#ifdef COHORT
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define COHORT_SOURCE_HASH              0
+#define COHORT_SOURCE_PROVISIONER       1
+#define COHORT_UNASSIGNED               0xFF        // Cohort Set value which returns to the hash
+
+#define COHORT_FNV_OFFSET               0x811C9DC5
+#define COHORT_FNV_PRIME                0x01000193
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    wiced_bool_t    early_sleep;                // sleep after a response without more data, with LPN_EARLY_SLEEP
+    uint32_t        poll_timeout;               // 100 ms units, 0 for the configured value
+    uint8_t         transmit_count;             // network transmissions of own messages, 0 for the configured count
+} cohort_params_t;
+
+typedef struct
+{
+    uint32_t        cycles;
+    uint32_t        awake_10us;
+    uint32_t        sleep_ms;
+    uint32_t        messages;
+    uint64_t        interval_total_ms;          // sum of the intervals between polls
+    uint64_t        interval_sq_total;          // sum of the squared intervals, ms * ms
+    uint32_t        interval_max_ms;
+} cohort_stats_t;
+
+// Saved in NVRAM on assignment and before HID-off
+typedef struct
+{
+    uint16_t        experiment;
+    uint8_t         cohort;
+    uint8_t         source;
+    uint8_t         configured_transmit_count;  // Network Transmit count of the provisioner, 0 if not read
+    uint8_t         applied_transmit_count;     // count set by the cohort, 0 if not set
+    cohort_stats_t  stats;
+} cohort_nvram_t;
+
+typedef struct
+{
+    cohort_nvram_t  nvram;
+    uint32_t        configured_poll_timeout;    // used by the cohorts without their own poll timeout
+    uint64_t        awake_start_us;             // 0 when sleeping
+    uint64_t        sleep_start_us;             // 0 when awake
+    uint64_t        last_poll_us;               // end of the previous poll cycle, 0 if not known
+    wiced_bool_t    initialized;
+} cohort_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static uint8_t cohort_hash(void);
+static void cohort_assign(uint8_t cohort, uint8_t source);
+static void cohort_apply(wiced_bool_t at_init);
+#ifdef COHORT_TRANSMIT_COUNT
+static void cohort_apply_transmit_count(const cohort_params_t *p_params);
+#endif
+static void cohort_add_interval(uint32_t interval_ms);
+static void cohort_send_status(wiced_bt_mesh_event_t *p_event);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+extern wiced_bt_mesh_core_config_t mesh_config;
+
+/*
+ * Parameter sets of the experiment, edit together with COHORT_EXPERIMENT
+ */
+static const cohort_params_t cohort_params[COHORT_MAX] =
+{
+    { WICED_TRUE,  0,   0 },                    // 0: control, build settings
+    { WICED_TRUE,  300, 1 },                    // 1: poll every 30 s, own messages sent once
+    { WICED_FALSE, 0,   0 },                    // 2: scan until the end of the receive window
+    { WICED_TRUE,  600, 1 },                    // 3: poll every 60 s, own messages sent once
+};
+
+static cohort_state_t cohort = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Restore the cohort and the statistics, or assign the cohort from the device address.
+ * Called on every init after friendship_cfg_init and before the modules which change the
+ * poll timeout. The state is kept in RAM after the first init.
+ */
+void cohort_init(void)
+{
+    wiced_result_t result;
+
+    if (!cohort.initialized)
+    {
+        cohort.initialized = WICED_TRUE;
+        cohort.configured_poll_timeout = mesh_config.low_power.poll_timeout;
+
+        if ((wiced_hal_read_nvram(LOW_POWER_LED_NVRAM_ID_COHORT, sizeof(cohort.nvram), (uint8_t *)&cohort.nvram, &result) != sizeof(cohort.nvram)) ||
+            (result != WICED_SUCCESS))
+        {
+            // Nothing saved
+            memset(&cohort.nvram, 0, sizeof(cohort.nvram));
+            cohort_assign(cohort_hash(), COHORT_SOURCE_HASH);
+        }
+        else if ((cohort.nvram.experiment != COHORT_EXPERIMENT) || (cohort.nvram.cohort >= COHORT_NUM))
+        {
+            // Saved for another experiment
+            cohort_assign(cohort_hash(), COHORT_SOURCE_HASH);
+        }
+        cohort.awake_start_us = clock_SystemTimeMicroseconds64();
+        cohort.sleep_start_us = 0;
+    }
+    WICED_BT_TRACE("cohort experiment:%d cohort:%d source:%d\n", cohort.nvram.experiment, cohort.nvram.cohort, cohort.nvram.source);
+    cohort_apply(WICED_TRUE);
+}
+
+/*
+ * FNV-1a hash of the device address and the experiment
+ */
+static uint8_t cohort_hash(void)
+{
+    wiced_bt_device_address_t bd_addr;
+    uint32_t hash = COHORT_FNV_OFFSET;
+    int i;
+
+    wiced_bt_dev_read_local_addr(bd_addr);
+    for (i = 0; i < BD_ADDR_LEN; i++)
+        hash = (hash ^ bd_addr[i]) * COHORT_FNV_PRIME;
+    hash = (hash ^ (COHORT_EXPERIMENT & 0xff)) * COHORT_FNV_PRIME;
+    hash = (hash ^ (COHORT_EXPERIMENT >> 8)) * COHORT_FNV_PRIME;
+
+    return (uint8_t)(hash % COHORT_NUM);
+}
+
+/*
+ * Start a new cohort membership, the statistics start again
+ */
+static void cohort_assign(uint8_t cohort_id, uint8_t source)
+{
+    uint8_t        configured_transmit_count = cohort.nvram.configured_transmit_count;
+    uint8_t        applied_transmit_count    = cohort.nvram.applied_transmit_count;
+    wiced_result_t result;
+
+    memset(&cohort.nvram, 0, sizeof(cohort.nvram));
+    // The count to restore is kept, the core still uses the count of the previous cohort
+    cohort.nvram.configured_transmit_count = configured_transmit_count;
+    cohort.nvram.applied_transmit_count    = applied_transmit_count;
+    cohort.nvram.experiment = COHORT_EXPERIMENT;
+    cohort.nvram.cohort     = cohort_id;
+    cohort.nvram.source     = source;
+    nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_COHORT, sizeof(cohort.nvram), (uint8_t *)&cohort.nvram, &result);
+}
+
+/*
+ * Apply the parameter set of the cohort. The poll timeout is used in the next Friend Request.
+ */
+static void cohort_apply(wiced_bool_t at_init)
+{
+    const cohort_params_t *p_params = &cohort_params[cohort.nvram.cohort];
+
+    mesh_config.low_power.poll_timeout = (p_params->poll_timeout != 0) ? p_params->poll_timeout : cohort.configured_poll_timeout;
+#ifdef LPN_POLL_SPREAD
+    if (!at_init)
+        mesh_low_power_led_spread_poll(WICED_TRUE);
+#endif
+#ifdef COHORT_TRANSMIT_COUNT
+    cohort_apply_transmit_count(p_params);
+#endif
+}
+
+#ifdef COHORT_TRANSMIT_COUNT
+/*
+ * Lower the Network Transmit count to the count of the cohort, or restore the configured count
+ */
+static void cohort_apply_transmit_count(const cohort_params_t *p_params)
+{
+    uint8_t        current = wiced_bt_mesh_core_get_network_transmit_count();
+    uint8_t        count;
+    wiced_result_t result;
+
+    // Another count than the one the cohort set was configured by the provisioner since
+    if ((cohort.nvram.applied_transmit_count == 0) || (current != cohort.nvram.applied_transmit_count))
+        cohort.nvram.configured_transmit_count = current;
+
+    count = p_params->transmit_count;
+    if ((count == 0) || (count > cohort.nvram.configured_transmit_count))
+        count = cohort.nvram.configured_transmit_count;
+
+    if (count != current)
+        wiced_bt_mesh_core_set_network_transmit_count(count);
+
+    WICED_BT_TRACE("cohort transmit count:%d configured:%d\n", count, cohort.nvram.configured_transmit_count);
+
+    if (count != cohort.nvram.applied_transmit_count)
+    {
+        // Saved, so that the configured count is restored also after HID-off
+        cohort.nvram.applied_transmit_count = count;
+        nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_COHORT, sizeof(cohort.nvram), (uint8_t *)&cohort.nvram, &result);
+    }
+}
+#endif
+
+/*
+ * Returns WICED_TRUE if the cohort sleeps after a response without more data
+ */
+wiced_bool_t cohort_early_sleep(void)
+{
+    return cohort_params[cohort.nvram.cohort].early_sleep;
+}
+
+/*
+ * The configured poll timeout is changed. Returns the poll timeout of the cohort, or
+ * poll_timeout if the cohort uses the configured value.
+ */
+uint32_t cohort_poll_timeout(uint32_t poll_timeout)
+{
+    cohort.configured_poll_timeout = poll_timeout;
+    return (cohort_params[cohort.nvram.cohort].poll_timeout != 0) ? cohort_params[cohort.nvram.cohort].poll_timeout : poll_timeout;
+}
+
+/*
+ * Node wakes up from ePDS
+ */
+void cohort_wake(void)
+{
+    uint64_t now_us = clock_SystemTimeMicroseconds64();
+
+    if (cohort.sleep_start_us != 0)
+        cohort.nvram.stats.sleep_ms += (uint32_t)((now_us - cohort.sleep_start_us) / 1000);
+    cohort.sleep_start_us = 0;
+    cohort.awake_start_us = now_us;
+}
+
+/*
+ * Node goes to sleep, the poll cycle is complete
+ */
+void cohort_sleep(void)
+{
+    uint64_t now_us = clock_SystemTimeMicroseconds64();
+
+    if (cohort.awake_start_us != 0)
+    {
+        cohort.nvram.stats.cycles++;
+        cohort.nvram.stats.awake_10us += (uint32_t)((now_us - cohort.awake_start_us) / 10);
+    }
+    if (cohort.last_poll_us != 0)
+        cohort_add_interval((uint32_t)((now_us - cohort.last_poll_us) / 1000));
+    cohort.last_poll_us   = now_us;
+    cohort.awake_start_us = 0;
+    cohort.sleep_start_us = now_us;
+}
+
+/*
+ * Add the interval between two poll cycles
+ */
+static void cohort_add_interval(uint32_t interval_ms)
+{
+    cohort.nvram.stats.interval_total_ms += interval_ms;
+    cohort.nvram.stats.interval_sq_total += (uint64_t)interval_ms * interval_ms;
+    if (interval_ms > cohort.nvram.stats.interval_max_ms)
+        cohort.nvram.stats.interval_max_ms = interval_ms;
+}
+
+/*
+ * Message received by the application
+ */
+void cohort_message(void)
+{
+    cohort.nvram.stats.messages++;
+}
+
+/*
+ * Save the statistics before HID-off, the sleep duration is counted in advance
+ */
+void cohort_save(uint32_t sleep_ms)
+{
+    wiced_result_t result;
+
+    cohort.nvram.stats.sleep_ms += sleep_ms;
+    // The interval ends with the poll after HID-off, which starts without the time of this poll
+    cohort_add_interval(sleep_ms);
+    nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_COHORT, sizeof(cohort.nvram), (uint8_t *)&cohort.nvram, &result);
+}
+
+/*
+ * Clear the statistics, the cohort is kept
+ */
+void cohort_reset(void)
+{
+    memset(&cohort.nvram.stats, 0, sizeof(cohort.nvram.stats));
+}
+
+/*
+ * Process Cohort Get and Set
+ */
+void cohort_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    uint16_t experiment;
+
+    if (p_event->opcode == MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_SET)
+    {
+        // Experiment (2), cohort (1), a Set for another experiment is ignored
+        if (data_len != 3)
+        {
+            wiced_bt_mesh_release_event(p_event);
+            return;
+        }
+        STREAM_TO_UINT16(experiment, p_data);
+        if ((experiment == COHORT_EXPERIMENT) && ((p_data[0] < COHORT_NUM) || (p_data[0] == COHORT_UNASSIGNED)))
+        {
+            if (p_data[0] == COHORT_UNASSIGNED)
+                cohort_assign(cohort_hash(), COHORT_SOURCE_HASH);
+            else if ((p_data[0] != cohort.nvram.cohort) || (cohort.nvram.source != COHORT_SOURCE_PROVISIONER))
+                cohort_assign(p_data[0], COHORT_SOURCE_PROVISIONER);
+            cohort_apply(WICED_FALSE);
+            WICED_BT_TRACE("cohort set:%d source:%d\n", cohort.nvram.cohort, cohort.nvram.source);
+        }
+    }
+    cohort_send_status(p_event);
+}
+
+/*
+ * Serialize the cohort and the statistics. Returns length.
+ */
+uint16_t cohort_serialize_stats(uint8_t *p_buffer)
+{
+    const cohort_params_t *p_params = &cohort_params[cohort.nvram.cohort];
+    cohort_stats_t *p_stats = &cohort.nvram.stats;
+    uint32_t latency_mean_ms = 0;
+    uint32_t latency_max_ms = 0;
+    uint8_t *p = p_buffer;
+
+    // A message which reaches the friend at a random time waits for the next poll, on average
+    // E[I * I] / 2E[I] for the measured intervals I, then the receive delay. The longest interval
+    // bounds the latency.
+    if (p_stats->interval_total_ms != 0)
+    {
+        latency_mean_ms = (uint32_t)(p_stats->interval_sq_total / (2 * p_stats->interval_total_ms)) + mesh_config.low_power.receive_delay;
+        latency_max_ms  = p_stats->interval_max_ms + mesh_config.low_power.receive_delay;
+    }
+
+    UINT16_TO_STREAM(p, cohort.nvram.experiment);
+    UINT8_TO_STREAM(p, cohort.nvram.cohort);
+    UINT8_TO_STREAM(p, cohort.nvram.source);
+#ifdef LPN_EARLY_SLEEP
+    UINT8_TO_STREAM(p, p_params->early_sleep);
+#else
+    UINT8_TO_STREAM(p, 0);
+#endif
+    UINT24_TO_STREAM(p, mesh_config.low_power.poll_timeout);
+#ifdef COHORT_TRANSMIT_COUNT
+    UINT8_TO_STREAM(p, cohort.nvram.applied_transmit_count);
+#else
+    UINT8_TO_STREAM(p, 0);
+#endif
+    UINT8_TO_STREAM(p, mesh_config.low_power.receive_delay);
+    UINT32_TO_STREAM(p, cohort.nvram.stats.cycles);
+    UINT32_TO_STREAM(p, cohort.nvram.stats.awake_10us);
+    UINT32_TO_STREAM(p, cohort.nvram.stats.sleep_ms);
+    UINT32_TO_STREAM(p, cohort.nvram.stats.messages);
+    UINT32_TO_STREAM(p, latency_mean_ms);
+    UINT32_TO_STREAM(p, latency_max_ms);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send Cohort Status
+ */
+static void cohort_send_status(wiced_bt_mesh_event_t *p_event)
+{
+    uint8_t buffer[COHORT_STATS_LEN];
+
+    mesh_low_power_led_vendor_send(wiced_bt_mesh_create_reply_event(p_event), MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_STATUS, buffer, cohort_serialize_stats(buffer));
+}
+
+/*
+ * Send the statistics to the host
+ */
+void cohort_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[COHORT_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_COHORT_STATS, buffer, cohort_serialize_stats(buffer));
+#endif
+}
+
+#endif // COHORT
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Experiment cohorts of low power nodes API definition
+ */
+
+#ifndef __COHORT__H
+#define __COHORT__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COHORT_MAX                          4       // parameter sets in cohort.c
+
+#ifndef COHORT_NUM
+#define COHORT_NUM                          2
+#endif
+#ifndef COHORT_EXPERIMENT
+#define COHORT_EXPERIMENT                   1
+#endif
+#if (COHORT_NUM < 1) || (COHORT_NUM > COHORT_MAX)
+#error COHORT_NUM must be 1 to 4
+#endif
+
+/*
+ * Serialized cohort and statistics, little endian
+ *   experiment (2), cohort (1), source (1, 0 hash of the device address, 1 provisioner),
+ *   early sleep (1), poll timeout in 100 ms units (3), network transmit count (1, 0 configured
+ *   by the provisioner), receive delay in ms (1), poll cycles (4), awake time in 10 us units (4),
+ *   sleep time in ms (4), messages received (4), mean and maximum delivery latency from the poll
+ *   intervals in ms (4 each). tools/cohort/cohort_report.py reads this record.
+ */
+#define COHORT_STATS_LEN                    (2 + 1 + 1 + 1 + 3 + 1 + 1 + 4 + 4 + 4 + 4 + 4 + 4)
+
+/*
+ * Restore or assign the cohort and apply its parameter set
+ */
+void cohort_init(void);
+
+/*
+ * Returns WICED_TRUE if the cohort sleeps after a response without more data
+ */
+wiced_bool_t cohort_early_sleep(void);
+
+/*
+ * The configured poll timeout is changed. Returns the poll timeout of the cohort, or
+ * poll_timeout if the cohort uses the configured value.
+ */
+uint32_t cohort_poll_timeout(uint32_t poll_timeout);
+
+/*
+ * Node wakes up from ePDS
+ */
+void cohort_wake(void);
+
+/*
+ * Node goes to sleep
+ */
+void cohort_sleep(void);
+
+/*
+ * Message received by the application
+ */
+void cohort_message(void);
+
+/*
+ * Save the statistics before HID-off
+ */
+void cohort_save(uint32_t sleep_ms);
+
+/*
+ * Clear the statistics
+ */
+void cohort_reset(void);
+
+/*
+ * Process Cohort Get and Set
+ */
+void cohort_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+/*
+ * Serialize the cohort and the statistics. Returns length.
+ */
+uint16_t cohort_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void cohort_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Mesh 1.1 directed forwarding. With managed flooding every relay retransmits every message,
+ * with directed forwarding a unicast message which uses a discovered path is relayed only by
+ * the forwarding nodes on the path. The mesh core runs the path discovery and keeps the
+ * forwarding table, the lighting node acts as directed relay and, for its low power nodes,
+ * as directed friend.
+ *
+ * A path costs a flooded Path Request and a Path Reply, so the node starts the discovery only
+ * for destinations it sends to frequently, for example the controller a sensor publishes to.
+ * The core asks before it discovers a path to a destination. The node counts the unicast
+ * messages per destination in a small table and agrees when DIRECTED_FWD_MIN_MESSAGES
+ * were sent to the destination within DIRECTED_FWD_WINDOW seconds. Messages to other
+ * destinations keep flooding.
+ *
+ * Directed forwarding of the prebuilt mesh core is configured by the provisioner, the core does
+ * not let the application enable it, decide about path discovery or observe the paths. The
+ * module is written against an assumed extension of the core API, wiced_bt_mesh_core_df_enable,
+ * wiced_bt_mesh_core_df_register_path_policy_cb, wiced_bt_mesh_core_df_register_event_cb and the
+ * WICED_BT_MESH_CORE_DF_EVENT_* events, and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "directed_fwd.h"
+
+#if defined(DIRECTED_FWD) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define DIRECTED_FWD_DEST_TABLE_SIZE    8           // destinations with message counts
+#define DIRECTED_FWD_MIN_MESSAGES       3           // messages to the destination in the window before a path is discovered
+#define DIRECTED_FWD_WINDOW             60          // seconds
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        dst;                        // unicast address, 0 if the entry is not used
+    uint16_t        messages;                   // messages sent in the window
+    uint32_t        window_start;               // seconds
+} directed_fwd_dest_t;
+
+typedef struct
+{
+    directed_fwd_dest_t dest[DIRECTED_FWD_DEST_TABLE_SIZE];
+    uint32_t        discoveries;                // path discoveries the node agreed to
+    uint32_t        established;                // paths from this node established
+    uint32_t        failed;                     // path discoveries without Path Reply
+    uint16_t        fwd_entries;                // forwarding table entries, the node is on the path
+    uint16_t        fwd_entries_max;
+} directed_fwd_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static void directed_fwd_event_cb(uint8_t event, uint16_t origin, uint16_t target);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static directed_fwd_state_t directed_fwd = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Enable directed relay and directed friend in the mesh core and register the path policy
+ */
+void directed_fwd_init(void)
+{
+    memset(directed_fwd.dest, 0, sizeof(directed_fwd.dest));
+    directed_fwd.fwd_entries = 0;
+
+    wiced_bt_mesh_core_df_enable(WICED_TRUE, WICED_TRUE);
+    wiced_bt_mesh_core_df_register_path_policy_cb(directed_fwd_discover_path);
+    wiced_bt_mesh_core_df_register_event_cb(directed_fwd_event_cb);
+}
+
+/*
+ * Called by the mesh core when the node sends a message to a unicast destination without a path.
+ * Returns WICED_TRUE if the core should start the path discovery.
+ */
+wiced_bool_t directed_fwd_discover_path(uint16_t dst)
+{
+    uint32_t            now = (uint32_t)(clock_SystemTimeMicroseconds64() / 1000000);
+    directed_fwd_dest_t *p_dest = NULL;
+    directed_fwd_dest_t *p_oldest = &directed_fwd.dest[0];
+    int                 i;
+
+    for (i = 0; i < DIRECTED_FWD_DEST_TABLE_SIZE; i++)
+    {
+        if (directed_fwd.dest[i].dst == dst)
+        {
+            p_dest = &directed_fwd.dest[i];
+            break;
+        }
+        if ((directed_fwd.dest[i].dst == 0) || (directed_fwd.dest[i].window_start < p_oldest->window_start))
+            p_oldest = &directed_fwd.dest[i];
+    }
+
+    // Destination sent to least recently is replaced
+    if ((p_dest == NULL) || (now - p_dest->window_start >= DIRECTED_FWD_WINDOW))
+    {
+        if (p_dest == NULL)
+            p_dest = p_oldest;
+        p_dest->dst          = dst;
+        p_dest->messages     = 0;
+        p_dest->window_start = now;
+    }
+
+    if (++p_dest->messages < DIRECTED_FWD_MIN_MESSAGES)
+        return WICED_FALSE;
+
+    // Discovery is requested again by the core if it fails, start a new window
+    p_dest->messages     = 0;
+    p_dest->window_start = now;
+    directed_fwd.discoveries++;
+
+    WICED_BT_TRACE("directed fwd discover path to:%04x\n", dst);
+    return WICED_TRUE;
+}
+
+/*
+ * Path and forwarding table events from the mesh core
+ */
+static void directed_fwd_event_cb(uint8_t event, uint16_t origin, uint16_t target)
+{
+    switch (event)
+    {
+    case WICED_BT_MESH_CORE_DF_EVENT_PATH_ESTABLISHED:
+        directed_fwd.established++;
+        break;
+
+    case WICED_BT_MESH_CORE_DF_EVENT_PATH_FAILED:
+        directed_fwd.failed++;
+        break;
+
+    case WICED_BT_MESH_CORE_DF_EVENT_FWD_ENTRY_ADDED:
+        if (++directed_fwd.fwd_entries > directed_fwd.fwd_entries_max)
+            directed_fwd.fwd_entries_max = directed_fwd.fwd_entries;
+        break;
+
+    case WICED_BT_MESH_CORE_DF_EVENT_FWD_ENTRY_REMOVED:
+        if (directed_fwd.fwd_entries != 0)
+            directed_fwd.fwd_entries--;
+        break;
+
+    default:
+        return;
+    }
+    WICED_BT_TRACE("directed fwd event:%d origin:%04x target:%04x\n", event, origin, target);
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t directed_fwd_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+
+    UINT32_TO_STREAM(p, directed_fwd.discoveries);
+    UINT32_TO_STREAM(p, directed_fwd.established);
+    UINT32_TO_STREAM(p, directed_fwd.failed);
+    UINT16_TO_STREAM(p, directed_fwd.fwd_entries);
+    UINT16_TO_STREAM(p, directed_fwd.fwd_entries_max);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void directed_fwd_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[DIRECTED_FWD_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_DIRECTED_FWD_STATS, buffer, directed_fwd_serialize_stats(buffer));
+#endif
+}
+
+#endif // DIRECTED_FWD && !LOW_POWER_NODE
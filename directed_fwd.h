@@ -0,0 +1,77 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Directed forwarding API definition
+ */
+
+#ifndef __DIRECTED_FWD__H
+#define __DIRECTED_FWD__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   path discoveries started (4), paths established (4), discoveries failed (4),
+ *   forwarding table entries (2) and their maximum (2)
+ */
+#define DIRECTED_FWD_STATS_LEN              (4 + 4 + 4 + 2 + 2)
+
+/*
+ * Enable directed relay and directed friend in the mesh core and register the path policy
+ */
+void directed_fwd_init(void);
+
+/*
+ * Called by the mesh core when the node sends a message to a unicast destination without a path.
+ * Returns WICED_TRUE if the core should start the path discovery.
+ */
+wiced_bool_t directed_fwd_discover_path(uint16_t dst);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t directed_fwd_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void directed_fwd_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
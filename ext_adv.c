@@ -0,0 +1,277 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Extended advertising bearer. A message longer than 15 bytes of upper transport PDU is split
+ * by the mesh core into segments of 12 bytes, every segment is a network PDU relayed on its own
+ * and sent one SAR segment interval after the previous one. The CYW20819 and CYW20820 support
+ * Bluetooth 5 extended advertising, between nodes running this firmware such a message is sent
+ * as one long network PDU of up to EXT_ADV_MAX_NET_PDU_LEN bytes in AUX_ADV_IND. Other nodes do
+ * not receive it, so the core asks the application before it uses the extended bearer:
+ *
+ * - unicast destination known to support it: long PDU
+ * - unicast destination known to use legacy advertising: segments
+ * - unknown unicast destination: long PDU, the lower transport acknowledges it like one segment.
+ *   Without the acknowledgement the core sends the message again in segments and the destination
+ *   is remembered as legacy for EXT_ADV_LEGACY_TIMEOUT.
+ * - group and virtual destinations: long PDU only with EXT_ADV_GROUPS, when every node in the
+ *   groups runs this firmware
+ *
+ * A message whose upper transport PDU with the network and lower transport headers does not fit
+ * in EXT_ADV_MAX_NET_PDU_LEN keeps the segments. The core reports the result of every long PDU,
+ * for a group destination when it has been sent, and only those results are counted.
+ *
+ * A long PDU received from a node marks the node as supporting the extended bearer.
+ *
+ * The prebuilt mesh core has no extended advertising bearer. The module is written against an
+ * assumed extension of the core API, wiced_bt_mesh_core_ext_adv_enable and
+ * wiced_bt_mesh_core_register_ext_adv_cb, and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "ext_adv.h"
+
+#if defined(EXT_ADV_BEARER) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define EXT_ADV_AUX_PAYLOAD_LEN         255         // PDU payload of AUX_ADV_IND
+#define EXT_ADV_EXT_HEADER_LEN          (1 + 1 + 6 + 2) // extended header length and AdvMode, flags, AdvA, ADI
+#define EXT_ADV_AD_HEADER_LEN           2           // AD length and type
+#define EXT_ADV_MAX_NET_PDU_LEN         (EXT_ADV_AUX_PAYLOAD_LEN - EXT_ADV_EXT_HEADER_LEN - EXT_ADV_AD_HEADER_LEN)
+#define EXT_ADV_PEERS                   16          // destinations with known bearer
+#define EXT_ADV_LEGACY_TIMEOUT          3600        // seconds before a legacy destination is tried again
+#define EXT_ADV_SEG_PAYLOAD_LEN         12          // upper transport bytes in one segment
+#define EXT_ADV_NET_OVERHEAD_LEN        (9 + 1 + 4) // network header, unsegmented lower transport header, NetMIC
+
+#define EXT_ADV_PEER_UNKNOWN            0
+#define EXT_ADV_PEER_EXTENDED           1
+#define EXT_ADV_PEER_LEGACY             2
+
+#define EXT_ADV_IS_UNICAST(addr)        (((addr) & 0x8000) == 0)
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        addr;                       // 0 if the entry is not used
+    uint8_t         bearer;                     // EXT_ADV_PEER_xxx
+    uint32_t        last_used;                  // seconds
+} ext_adv_peer_t;
+
+typedef struct
+{
+    ext_adv_peer_t  peers[EXT_ADV_PEERS];
+    uint32_t        tx_long;                    // messages sent as a long PDU
+    uint32_t        rx_long;
+    uint32_t        fallbacks;                  // long PDU not acknowledged, sent again in segments
+    uint32_t        segments_saved;             // segments the long PDUs replaced
+} ext_adv_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static wiced_bool_t ext_adv_select(uint16_t dst, uint16_t upper_len);
+static void ext_adv_tx_result(uint16_t dst, uint16_t upper_len, wiced_bool_t acked);
+static void ext_adv_rx(uint16_t src);
+static ext_adv_peer_t *ext_adv_find_peer(uint16_t addr);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static ext_adv_state_t ext_adv = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Enable the extended advertising bearer in the mesh core and register the bearer selection
+ */
+void ext_adv_init(void)
+{
+    memset(ext_adv.peers, 0, sizeof(ext_adv.peers));
+
+    wiced_bt_mesh_core_ext_adv_enable(EXT_ADV_MAX_NET_PDU_LEN);
+    wiced_bt_mesh_core_register_ext_adv_cb(ext_adv_select, ext_adv_tx_result, ext_adv_rx);
+}
+
+/*
+ * Called by the mesh core for a message which would be segmented. Returns WICED_TRUE to send it
+ * as one long network PDU.
+ */
+static wiced_bool_t ext_adv_select(uint16_t dst, uint16_t upper_len)
+{
+    ext_adv_peer_t *p_peer;
+    uint32_t       now;
+
+    if (upper_len + EXT_ADV_NET_OVERHEAD_LEN > EXT_ADV_MAX_NET_PDU_LEN)
+        return WICED_FALSE;
+
+    // Group messages are not acknowledged, the bearer can not be learned
+    if (!EXT_ADV_IS_UNICAST(dst))
+    {
+#if EXT_ADV_GROUPS
+        return WICED_TRUE;
+#else
+        return WICED_FALSE;
+#endif
+    }
+
+    now = (uint32_t)(clock_SystemTimeMicroseconds64() / 1000000);
+    p_peer = ext_adv_find_peer(dst);
+    if ((p_peer->bearer == EXT_ADV_PEER_LEGACY) && (now - p_peer->last_used < EXT_ADV_LEGACY_TIMEOUT))
+        return WICED_FALSE;
+
+    p_peer->last_used = now;
+    return WICED_TRUE;
+}
+
+/*
+ * Long PDU to a unicast destination was acknowledged or not, the core sends the message again in
+ * segments if it was not. A long PDU to a group destination is reported acknowledged when it
+ * has been sent.
+ */
+static void ext_adv_tx_result(uint16_t dst, uint16_t upper_len, wiced_bool_t acked)
+{
+    ext_adv_peer_t *p_peer;
+
+    if (!EXT_ADV_IS_UNICAST(dst))
+    {
+        if (acked)
+        {
+            ext_adv.tx_long++;
+            ext_adv.segments_saved += (upper_len + EXT_ADV_SEG_PAYLOAD_LEN - 1) / EXT_ADV_SEG_PAYLOAD_LEN - 1;
+        }
+        return;
+    }
+
+    p_peer = ext_adv_find_peer(dst);
+    p_peer->last_used = (uint32_t)(clock_SystemTimeMicroseconds64() / 1000000);
+    if (acked)
+    {
+        p_peer->bearer = EXT_ADV_PEER_EXTENDED;
+        ext_adv.tx_long++;
+        ext_adv.segments_saved += (upper_len + EXT_ADV_SEG_PAYLOAD_LEN - 1) / EXT_ADV_SEG_PAYLOAD_LEN - 1;
+    }
+    else
+    {
+        WICED_BT_TRACE("ext adv fallback dst:%04x\n", dst);
+        p_peer->bearer = EXT_ADV_PEER_LEGACY;
+        ext_adv.fallbacks++;
+    }
+}
+
+/*
+ * Long PDU received, the source supports the extended bearer
+ */
+static void ext_adv_rx(uint16_t src)
+{
+    ext_adv_peer_t *p_peer = ext_adv_find_peer(src);
+
+    p_peer->bearer    = EXT_ADV_PEER_EXTENDED;
+    p_peer->last_used = (uint32_t)(clock_SystemTimeMicroseconds64() / 1000000);
+    ext_adv.rx_long++;
+}
+
+/*
+ * Returns the peer entry of the address, a new entry replaces the least recently used one if
+ * the address is not found
+ */
+static ext_adv_peer_t *ext_adv_find_peer(uint16_t addr)
+{
+    ext_adv_peer_t *p_oldest = &ext_adv.peers[0];
+    int            i;
+
+    for (i = 0; i < EXT_ADV_PEERS; i++)
+    {
+        if (ext_adv.peers[i].addr == addr)
+            return &ext_adv.peers[i];
+        if ((ext_adv.peers[i].addr == 0) || ((p_oldest->addr != 0) && (ext_adv.peers[i].last_used < p_oldest->last_used)))
+            p_oldest = &ext_adv.peers[i];
+    }
+    p_oldest->addr      = addr;
+    p_oldest->bearer    = EXT_ADV_PEER_UNKNOWN;
+    p_oldest->last_used = 0;
+    return p_oldest;
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t ext_adv_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+    uint8_t extended = 0;
+    uint8_t legacy = 0;
+    int     i;
+
+    for (i = 0; i < EXT_ADV_PEERS; i++)
+    {
+        if (ext_adv.peers[i].bearer == EXT_ADV_PEER_EXTENDED)
+            extended++;
+        else if (ext_adv.peers[i].bearer == EXT_ADV_PEER_LEGACY)
+            legacy++;
+    }
+
+    UINT32_TO_STREAM(p, ext_adv.tx_long);
+    UINT32_TO_STREAM(p, ext_adv.rx_long);
+    UINT32_TO_STREAM(p, ext_adv.fallbacks);
+    UINT32_TO_STREAM(p, ext_adv.segments_saved);
+    UINT8_TO_STREAM(p, extended);
+    UINT8_TO_STREAM(p, legacy);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void ext_adv_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[EXT_ADV_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_EXT_ADV_STATS, buffer, ext_adv_serialize_stats(buffer));
+#endif
+}
+
+#endif // EXT_ADV_BEARER && !LOW_POWER_NODE
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Extended advertising bearer API definition
+ */
+
+#ifndef __EXT_ADV__H
+#define __EXT_ADV__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef EXT_ADV_GROUPS
+#define EXT_ADV_GROUPS                      0       // 1 if every node in the groups supports the extended bearer
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   messages sent as a long PDU (4), long PDUs received (4), fallbacks to segments (4),
+ *   segments saved (4), destinations known to support the extended bearer (1) and to use
+ *   legacy advertising (1)
+ */
+#define EXT_ADV_STATS_LEN                   (4 + 4 + 4 + 4 + 1 + 1)
+
+/*
+ * Enable the extended advertising bearer in the mesh core and register the bearer selection
+ */
+void ext_adv_init(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t ext_adv_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void ext_adv_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Friend cache overflow policy. When a message for an LPN does not fit in the friend cache,
+ * the mesh core asks the application which message to discard. The entries are passed
+ * oldest first and the core asks again until the new message fits.
+ *
+ * The friend does not have the application keys, so the priority policy works on the network
+ * and lower transport headers. Lighting messages carry the state, so an unsegmented access
+ * message is superseded by a newer message from the same source to the same destination. The
+ * newest message of each source and destination pair is never discarded while a superseded
+ * message exists in the cache. Segments of segmented messages are not superseded because
+ * losing one segment loses the whole message. When no message is superseded, the oldest entry
+ * whose source and destination pair has a newer entry in the cache or is the pair of the new
+ * message is discarded, so that every pair keeps its newest message. Only when every pair has
+ * a single entry the oldest entry is discarded.
+ *
+ * The prebuilt mesh core discards the oldest message itself and does not ask the application.
+ * The module is written against an assumed extension of the core API,
+ * wiced_bt_mesh_core_friend_register_cache_evict_cb with wiced_bt_mesh_core_friend_cache_entry_t
+ * and WICED_BT_MESH_CORE_FRIEND_CACHE_DROP_NEW, and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "friend_cache_policy.h"
+
+#if (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)) && (FRIEND_CACHE_POLICY != FRIEND_CACHE_POLICY_DROP_OLDEST)
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static uint8_t friend_cache_policy_select(wiced_bt_mesh_core_friend_cache_entry_t *p_entries, uint8_t num_entries, wiced_bt_mesh_core_friend_cache_entry_t *p_new);
+#if (FRIEND_CACHE_POLICY == FRIEND_CACHE_POLICY_PRIORITY)
+static wiced_bool_t friend_cache_policy_superseded(wiced_bt_mesh_core_friend_cache_entry_t *p_entry, wiced_bt_mesh_core_friend_cache_entry_t *p_newer, uint8_t num_newer);
+static wiced_bool_t friend_cache_policy_same_pair(wiced_bt_mesh_core_friend_cache_entry_t *p_entry, wiced_bt_mesh_core_friend_cache_entry_t *p_newer, uint8_t num_newer);
+#endif
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Register the overflow policy with the mesh core
+ */
+void friend_cache_policy_init(void)
+{
+    WICED_BT_TRACE("friend cache policy:%d\n", FRIEND_CACHE_POLICY);
+    wiced_bt_mesh_core_friend_register_cache_evict_cb(friend_cache_policy_select);
+}
+
+/*
+ * Returns index of the entry to discard, or WICED_BT_MESH_CORE_FRIEND_CACHE_DROP_NEW to discard the new message
+ */
+static uint8_t friend_cache_policy_select(wiced_bt_mesh_core_friend_cache_entry_t *p_entries, uint8_t num_entries, wiced_bt_mesh_core_friend_cache_entry_t *p_new)
+{
+#if (FRIEND_CACHE_POLICY == FRIEND_CACHE_POLICY_PRIORITY)
+    uint8_t i;
+
+    // Oldest superseded message. Entries after it and the new message are newer.
+    for (i = 0; i < num_entries; i++)
+    {
+        if (friend_cache_policy_superseded(&p_entries[i], &p_entries[i + 1], num_entries - i - 1) ||
+            friend_cache_policy_superseded(&p_entries[i], p_new, 1))
+        {
+            return i;
+        }
+    }
+    // Oldest entry of a pair which keeps a newer entry
+    for (i = 0; i < num_entries; i++)
+    {
+        if (friend_cache_policy_same_pair(&p_entries[i], &p_entries[i + 1], num_entries - i - 1) ||
+            friend_cache_policy_same_pair(&p_entries[i], p_new, 1))
+        {
+            return i;
+        }
+    }
+    // Every pair has a single entry, oldest one
+    return 0;
+#else
+    return WICED_BT_MESH_CORE_FRIEND_CACHE_DROP_NEW;
+#endif
+}
+
+#if (FRIEND_CACHE_POLICY == FRIEND_CACHE_POLICY_PRIORITY)
+/*
+ * Returns WICED_TRUE if one of the newer entries replaces the state carried by the entry
+ */
+static wiced_bool_t friend_cache_policy_superseded(wiced_bt_mesh_core_friend_cache_entry_t *p_entry, wiced_bt_mesh_core_friend_cache_entry_t *p_newer, uint8_t num_newer)
+{
+    uint8_t i;
+
+    if (p_entry->ctl || p_entry->seg)
+        return WICED_FALSE;
+
+    for (i = 0; i < num_newer; i++)
+    {
+        if (!p_newer[i].ctl && !p_newer[i].seg && (p_newer[i].src == p_entry->src) && (p_newer[i].dst == p_entry->dst))
+            return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
+/*
+ * Returns WICED_TRUE if one of the newer entries has the same source and destination as the entry
+ */
+static wiced_bool_t friend_cache_policy_same_pair(wiced_bt_mesh_core_friend_cache_entry_t *p_entry, wiced_bt_mesh_core_friend_cache_entry_t *p_newer, uint8_t num_newer)
+{
+    uint8_t i;
+
+    for (i = 0; i < num_newer; i++)
+    {
+        if ((p_newer[i].src == p_entry->src) && (p_newer[i].dst == p_entry->dst))
+            return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+#endif
+
+#endif // !LOW_POWER_NODE && FRIEND_CACHE_POLICY != FRIEND_CACHE_POLICY_DROP_OLDEST
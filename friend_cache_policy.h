@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Friend cache overflow policy API definition
+ */
+
+#ifndef __FRIEND_CACHE_POLICY__H
+#define __FRIEND_CACHE_POLICY__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRIEND_CACHE_POLICY_DROP_OLDEST     0       // discard the oldest message, default behavior of the mesh core
+#define FRIEND_CACHE_POLICY_DROP_NEWEST     1       // keep the cache, discard the new message
+#define FRIEND_CACHE_POLICY_PRIORITY        2       // discard superseded messages, then older messages of a pair, then the oldest
+
+#ifndef FRIEND_CACHE_POLICY
+#define FRIEND_CACHE_POLICY                 FRIEND_CACHE_POLICY_DROP_OLDEST
+#endif
+
+/*
+ * Register the overflow policy with the mesh core
+ */
+void friend_cache_policy_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
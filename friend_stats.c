@@ -0,0 +1,288 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Friend node per LPN statistics. The mesh core reports friend cache and friendship events,
+ * the application counts them per LPN address so that it is possible to tell whether the
+ * friend or the LPN is at fault when an LPN misbehaves. Statistics can be read over WICED HCI
+ * and with the vendor Friend Stats Get message.
+ *
+ * The prebuilt mesh core does not report friend events to the application. The module is
+ * written against an assumed extension of the core API, wiced_bt_mesh_core_friend_register_event_cb,
+ * and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "low_power_led.h"
+#include "low_power_led_vendor.h"
+#include "low_power_led_hci.h"
+#include "friend_stats.h"
+
+#if defined(FRIEND_STATS) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        lpn_addr;                   // 0 if entry is not used
+    uint8_t         established;
+    uint16_t        friendships;
+    uint16_t        terminations;
+    uint32_t        enqueued;
+    uint32_t        delivered;
+    uint32_t        cache_overflows;            // message received while the cache was full
+    uint32_t        evictions;                  // message removed from the cache without delivery
+    uint32_t        missed_polls;               // poll was expected but not received
+    uint32_t        latency_sum;                // enqueue to delivery, ms
+    uint32_t        latency_max;
+    uint16_t        latency_hist[FRIEND_STATS_LATENCY_BUCKETS];
+    uint32_t        last_event;                 // sequence number of the last event, for replacement
+} friend_stats_lpn_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static void friend_stats_core_event_cb(wiced_bt_mesh_core_friend_event_t *p_event);
+static friend_stats_lpn_t *friend_stats_find(uint16_t lpn_addr);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static const uint32_t friend_stats_latency_limits[FRIEND_STATS_LATENCY_BUCKETS - 1] = { 500, 1000, 2000, 5000, 10000, 20000, 60000 };
+
+static friend_stats_lpn_t friend_stats[FRIEND_STATS_MAX_LPN];
+static uint32_t           friend_stats_event_seq = 0;
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Initialize friend statistics and register for the friend events of the mesh core
+ */
+void friend_stats_init(void)
+{
+    wiced_bt_mesh_core_friend_register_event_cb(friend_stats_core_event_cb);
+}
+
+/*
+ * Clear statistics of all LPNs. Friendship state of the current friends is kept.
+ */
+void friend_stats_reset(void)
+{
+    int i;
+
+    for (i = 0; i < FRIEND_STATS_MAX_LPN; i++)
+    {
+        uint16_t lpn_addr    = friend_stats[i].lpn_addr;
+        uint8_t  established = friend_stats[i].established;
+
+        memset(&friend_stats[i], 0, sizeof(friend_stats_lpn_t));
+        if (established)
+        {
+            friend_stats[i].lpn_addr    = lpn_addr;
+            friend_stats[i].established = established;
+        }
+    }
+}
+
+/*
+ * Friend event reported by the mesh core
+ */
+static void friend_stats_core_event_cb(wiced_bt_mesh_core_friend_event_t *p_event)
+{
+    friend_stats_lpn_t *p_lpn = friend_stats_find(p_event->lpn_addr);
+    int                 bucket;
+
+    if (p_lpn == NULL)
+        return;
+
+    p_lpn->last_event = ++friend_stats_event_seq;
+
+    switch (p_event->type)
+    {
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_ESTABLISHED:
+        p_lpn->established = WICED_TRUE;
+        p_lpn->friendships++;
+        WICED_BT_TRACE("friend stats lpn:%04x established\n", p_event->lpn_addr);
+        break;
+
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_TERMINATED:
+        p_lpn->established = WICED_FALSE;
+        p_lpn->terminations++;
+        WICED_BT_TRACE("friend stats lpn:%04x terminated\n", p_event->lpn_addr);
+        break;
+
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_ENQUEUED:
+        p_lpn->enqueued++;
+        break;
+
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_DELIVERED:
+        p_lpn->delivered++;
+        p_lpn->latency_sum += p_event->queued_time;
+        if (p_event->queued_time > p_lpn->latency_max)
+            p_lpn->latency_max = p_event->queued_time;
+        for (bucket = 0; bucket < FRIEND_STATS_LATENCY_BUCKETS - 1; bucket++)
+        {
+            if (p_event->queued_time < friend_stats_latency_limits[bucket])
+                break;
+        }
+        if (p_lpn->latency_hist[bucket] != 0xffff)
+            p_lpn->latency_hist[bucket]++;
+        break;
+
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_CACHE_OVERFLOW:
+        p_lpn->cache_overflows++;
+        break;
+
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_EVICTED:
+        p_lpn->evictions++;
+        break;
+
+    case WICED_BT_MESH_CORE_FRIEND_EVENT_POLL_MISSED:
+        p_lpn->missed_polls++;
+        break;
+
+    default:
+        break;
+    }
+}
+
+/*
+ * Find statistics entry of the LPN. If the LPN is not in the table, the entry of the LPN which
+ * is not a friend and was not active for the longest time is reused.
+ */
+static friend_stats_lpn_t *friend_stats_find(uint16_t lpn_addr)
+{
+    friend_stats_lpn_t *p_oldest = NULL;
+    int                 i;
+
+    for (i = 0; i < FRIEND_STATS_MAX_LPN; i++)
+    {
+        if (friend_stats[i].lpn_addr == lpn_addr)
+            return &friend_stats[i];
+    }
+    for (i = 0; i < FRIEND_STATS_MAX_LPN; i++)
+    {
+        if (friend_stats[i].established)
+            continue;
+        if ((p_oldest == NULL) || (friend_stats[i].lpn_addr == 0) || (friend_stats[i].last_event < p_oldest->last_event))
+        {
+            p_oldest = &friend_stats[i];
+            if (p_oldest->lpn_addr == 0)
+                break;
+        }
+    }
+    if (p_oldest != NULL)
+    {
+        memset(p_oldest, 0, sizeof(friend_stats_lpn_t));
+        p_oldest->lpn_addr = lpn_addr;
+    }
+    return p_oldest;
+}
+
+/*
+ * Serialize statistics of the LPN at index in the table. Returns length, or 0 if the entry is not used.
+ */
+uint16_t friend_stats_serialize(uint8_t index, uint8_t *p_buffer)
+{
+    friend_stats_lpn_t *p_lpn;
+    uint8_t            *p = p_buffer;
+    int                 i;
+
+    if ((index >= FRIEND_STATS_MAX_LPN) || (friend_stats[index].lpn_addr == 0))
+        return 0;
+
+    p_lpn = &friend_stats[index];
+
+    UINT16_TO_STREAM(p, p_lpn->lpn_addr);
+    UINT8_TO_STREAM(p, p_lpn->established);
+    UINT16_TO_STREAM(p, p_lpn->friendships);
+    UINT16_TO_STREAM(p, p_lpn->terminations);
+    UINT32_TO_STREAM(p, p_lpn->enqueued);
+    UINT32_TO_STREAM(p, p_lpn->delivered);
+    UINT32_TO_STREAM(p, p_lpn->cache_overflows);
+    UINT32_TO_STREAM(p, p_lpn->evictions);
+    UINT32_TO_STREAM(p, p_lpn->missed_polls);
+    UINT32_TO_STREAM(p, p_lpn->latency_sum);
+    UINT32_TO_STREAM(p, p_lpn->latency_max);
+    for (i = 0; i < FRIEND_STATS_LATENCY_BUCKETS; i++)
+        UINT16_TO_STREAM(p, p_lpn->latency_hist[i]);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send statistics of all LPNs to the host, one WICED HCI event per LPN
+ */
+void friend_stats_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t  buffer[FRIEND_STATS_RECORD_LEN];
+    uint16_t len;
+    uint8_t  i;
+
+    for (i = 0; i < FRIEND_STATS_MAX_LPN; i++)
+    {
+        if ((len = friend_stats_serialize(i, buffer)) != 0)
+            mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_FRIEND_STATS, buffer, len);
+    }
+#endif
+}
+
+/*
+ * Process Friend Stats Get vendor message. The parameter is the table index, reply contains the
+ * index followed by the record, or only the index if the entry is not used.
+ */
+void friend_stats_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    uint8_t  buffer[1 + FRIEND_STATS_RECORD_LEN];
+    uint16_t len;
+
+    if ((p_event->opcode != MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIEND_STATS_GET) || (data_len != 1))
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    buffer[0] = p_data[0];
+    len = friend_stats_serialize(p_data[0], &buffer[1]);
+
+    mesh_low_power_led_vendor_send(wiced_bt_mesh_create_reply_event(p_event), MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIEND_STATS_STATUS, buffer, 1 + len);
+}
+
+#endif // FRIEND_STATS && !LOW_POWER_NODE
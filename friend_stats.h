@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Friend node per LPN statistics API definition
+ */
+
+#ifndef __FRIEND_STATS__H
+#define __FRIEND_STATS__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRIEND_STATS_MAX_LPN                8       // statistics are kept for LPNs which are no longer friends too
+#define FRIEND_STATS_LATENCY_BUCKETS        8
+
+/*
+ * Serialized statistics of one LPN, little endian
+ *   LPN address (2), friendship established (1), friendships (2), terminations (2),
+ *   enqueued (4), delivered (4), cache overflows (4), evictions (4), missed polls (4),
+ *   latency sum ms (4), latency max ms (4), latency histogram (8 x 2)
+ * Latency histogram buckets end at 0.5, 1, 2, 5, 10, 20, 60 seconds, the last bucket is unbounded.
+ */
+#define FRIEND_STATS_RECORD_LEN             (2 + 1 + 2 + 2 + 4 * 7 + 2 * FRIEND_STATS_LATENCY_BUCKETS)
+
+/*
+ * Initialize friend statistics and register for the friend events of the mesh core
+ */
+void friend_stats_init(void);
+
+/*
+ * Clear statistics of all LPNs
+ */
+void friend_stats_reset(void);
+
+/*
+ * Serialize statistics of the LPN at index in the table. Returns length, or 0 if the entry is not used.
+ */
+uint16_t friend_stats_serialize(uint8_t index, uint8_t *p_buffer);
+
+/*
+ * Send statistics of all LPNs to the host, one WICED HCI event per LPN
+ */
+void friend_stats_hci_send(void);
+
+/*
+ * Process Friend Stats Get vendor message. The function takes ownership of the p_event.
+ */
+void friend_stats_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
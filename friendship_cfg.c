@@ -0,0 +1,308 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Friendship parameters set over the vendor model. The low power parameters of mesh_config
+ * (rssi_factor, receive_window_factor, min_cache_size_log, receive_delay, poll_timeout) and the
+ * friend parameters (receive_window, cache_buf_len, max_lpn_num) are compiled in. The
+ * provisioner reads and sets the parameters of the node role with Friendship Config Get and
+ * Set, the values are range checked, saved in NVRAM and copied to mesh_config. The mesh core
+ * uses them at the next friendship establishment: the LPN in its next Friend Request, the
+ * friend in its next Friend Offer. The friend cache is allocated by the core at start up, so a
+ * new cache_buf_len or max_lpn_num takes effect after a restart.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "low_power_led.h"
+#include "low_power_led_vendor.h"
+#include "nvram_wear.h"
+#include "friendship_cfg.h"
+#ifdef COHORT
+#include "cohort.h"
+#endif
+#ifdef FRIEND_STATS
+#include "friend_stats.h"
+#endif
+
+#ifdef FRIENDSHIP_CFG
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+// Ranges of the Friend Request fields, Mesh Profile 3.6.5.3
+#define FRIENDSHIP_CFG_FACTOR_MAX               3
+#define FRIENDSHIP_CFG_MIN_CACHE_SIZE_LOG_MIN   1
+#define FRIENDSHIP_CFG_MIN_CACHE_SIZE_LOG_MAX   7
+#define FRIENDSHIP_CFG_RECEIVE_DELAY_MIN        10          // ms
+#define FRIENDSHIP_CFG_POLL_TIMEOUT_MIN         0x00000A    // 100 ms units
+
+// LPN_POLL_SPREAD adds the offset of the node slot, the sum has to stay in the range
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1) && defined(LPN_POLL_SPREAD)
+#define FRIENDSHIP_CFG_RECEIVE_DELAY_MAX        (0xFF - (LPN_POLL_SPREAD_SLOTS - 1) * LPN_POLL_SPREAD_RECEIVE_DELAY_STEP)
+#define FRIENDSHIP_CFG_POLL_TIMEOUT_MAX         (0x34BBFF - (LPN_POLL_SPREAD_SLOTS - 1) * LPN_POLL_SPREAD_POLL_TIMEOUT_STEP)
+#else
+#define FRIENDSHIP_CFG_RECEIVE_DELAY_MAX        0xFF
+#define FRIENDSHIP_CFG_POLL_TIMEOUT_MAX         0x34BBFF
+#endif
+
+// Friend limits, cache_buf_len and max_lpn_num are bounded by the RAM of the friend
+#define FRIENDSHIP_CFG_RECEIVE_WINDOW_MIN       1           // ms
+#define FRIENDSHIP_CFG_CACHE_BUF_LEN_MIN        64
+#define FRIENDSHIP_CFG_CACHE_BUF_LEN_MAX        2048
+#ifdef FRIEND_STATS
+// LPNs beyond the statistics table would be left out of the statistics
+#define FRIENDSHIP_CFG_MAX_LPN_NUM_MAX          FRIEND_STATS_MAX_LPN
+#else
+#define FRIENDSHIP_CFG_MAX_LPN_NUM_MAX          16
+#endif
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+// Saved in NVRAM, the values of both roles so that the record does not depend on the build
+typedef struct
+{
+    uint8_t         rssi_factor;
+    uint8_t         receive_window_factor;
+    uint8_t         min_cache_size_log;
+    uint8_t         receive_delay;
+    uint32_t        poll_timeout;
+    uint8_t         receive_window;
+    uint8_t         max_lpn_num;
+    uint16_t        cache_buf_len;
+} friendship_cfg_nvram_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static uint8_t friendship_cfg_parse(friendship_cfg_nvram_t *p_cfg, uint8_t *p_data, uint16_t data_len);
+static wiced_bool_t friendship_cfg_valid(friendship_cfg_nvram_t *p_cfg);
+static void friendship_cfg_apply(wiced_bool_t at_init);
+static void friendship_cfg_send_status(wiced_bt_mesh_event_t *p_event, uint8_t status);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+extern wiced_bt_mesh_core_config_t mesh_config;
+
+static friendship_cfg_nvram_t friendship_cfg;
+static wiced_bool_t friendship_cfg_initialized = WICED_FALSE;
+static uint8_t friendship_cfg_flags = 0;
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Read the saved parameters and copy them to mesh_config. Compiled values are used if nothing
+ * valid is saved. Called on every init before the other modules which use mesh_config.
+ */
+void friendship_cfg_init(void)
+{
+    friendship_cfg_nvram_t saved;
+    wiced_result_t result;
+
+    if (!friendship_cfg_initialized)
+    {
+        friendship_cfg.rssi_factor           = mesh_config.low_power.rssi_factor;
+        friendship_cfg.receive_window_factor = mesh_config.low_power.receive_window_factor;
+        friendship_cfg.min_cache_size_log    = mesh_config.low_power.min_cache_size_log;
+        friendship_cfg.receive_delay         = mesh_config.low_power.receive_delay;
+        friendship_cfg.poll_timeout          = mesh_config.low_power.poll_timeout;
+        friendship_cfg.receive_window        = mesh_config.friend_cfg.receive_window;
+        friendship_cfg.cache_buf_len         = mesh_config.friend_cfg.cache_buf_len;
+        friendship_cfg.max_lpn_num           = mesh_config.friend_cfg.max_lpn_num;
+
+        if ((wiced_hal_read_nvram(LOW_POWER_LED_NVRAM_ID_FRIENDSHIP_CFG, sizeof(saved), (uint8_t *)&saved, &result) == sizeof(saved)) &&
+            (result == WICED_SUCCESS))
+        {
+            if (friendship_cfg_valid(&saved))
+                friendship_cfg = saved;
+            else
+                WICED_BT_TRACE("friendship cfg: saved values out of range\n");
+        }
+        friendship_cfg_initialized = WICED_TRUE;
+    }
+    // Restores the configured values, LPN_POLL_SPREAD adds its offsets again
+    friendship_cfg_apply(WICED_TRUE);
+}
+
+/*
+ * Process Friendship Config Get and Set
+ */
+void friendship_cfg_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    friendship_cfg_nvram_t cfg = friendship_cfg;
+    wiced_result_t result;
+    uint8_t status;
+
+    if (p_event->opcode == MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_GET)
+    {
+        friendship_cfg_send_status(p_event, FRIENDSHIP_CFG_STATUS_SUCCESS);
+        return;
+    }
+
+    status = friendship_cfg_parse(&cfg, p_data, data_len);
+    if ((status == FRIENDSHIP_CFG_STATUS_SUCCESS) && !friendship_cfg_valid(&cfg))
+        status = FRIENDSHIP_CFG_STATUS_OUT_OF_RANGE;
+
+    if (status == FRIENDSHIP_CFG_STATUS_SUCCESS)
+    {
+        if (nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_FRIENDSHIP_CFG, sizeof(cfg), (uint8_t *)&cfg, &result) != sizeof(cfg))
+        {
+            status = FRIENDSHIP_CFG_STATUS_NVRAM_FAILED;
+        }
+        else
+        {
+#if !defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)
+            if ((cfg.cache_buf_len != friendship_cfg.cache_buf_len) || (cfg.max_lpn_num != friendship_cfg.max_lpn_num))
+                friendship_cfg_flags |= FRIENDSHIP_CFG_FLAG_RESTART;
+#endif
+            friendship_cfg = cfg;
+            friendship_cfg_apply(WICED_FALSE);
+            friendship_cfg_flags |= FRIENDSHIP_CFG_FLAG_PENDING;
+        }
+    }
+    WICED_BT_TRACE("friendship cfg set status:%d\n", status);
+
+    friendship_cfg_send_status(p_event, status);
+}
+
+/*
+ * Parse Friendship Config Set of the node role into p_cfg. Returns status.
+ */
+static uint8_t friendship_cfg_parse(friendship_cfg_nvram_t *p_cfg, uint8_t *p_data, uint16_t data_len)
+{
+    if ((data_len != FRIENDSHIP_CFG_PARAMS_LEN + 1) || (p_data[0] != FRIENDSHIP_CFG_ROLE))
+        return FRIENDSHIP_CFG_STATUS_INVALID;
+    p_data++;
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    STREAM_TO_UINT8(p_cfg->rssi_factor, p_data);
+    STREAM_TO_UINT8(p_cfg->receive_window_factor, p_data);
+    STREAM_TO_UINT8(p_cfg->min_cache_size_log, p_data);
+    STREAM_TO_UINT8(p_cfg->receive_delay, p_data);
+    STREAM_TO_UINT24(p_cfg->poll_timeout, p_data);
+#else
+    STREAM_TO_UINT8(p_cfg->receive_window, p_data);
+    STREAM_TO_UINT16(p_cfg->cache_buf_len, p_data);
+    STREAM_TO_UINT8(p_cfg->max_lpn_num, p_data);
+#endif
+    return FRIENDSHIP_CFG_STATUS_SUCCESS;
+}
+
+/*
+ * Check the parameters of the node role
+ */
+static wiced_bool_t friendship_cfg_valid(friendship_cfg_nvram_t *p_cfg)
+{
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    return (p_cfg->rssi_factor <= FRIENDSHIP_CFG_FACTOR_MAX) &&
+           (p_cfg->receive_window_factor <= FRIENDSHIP_CFG_FACTOR_MAX) &&
+           (p_cfg->min_cache_size_log >= FRIENDSHIP_CFG_MIN_CACHE_SIZE_LOG_MIN) &&
+           (p_cfg->min_cache_size_log <= FRIENDSHIP_CFG_MIN_CACHE_SIZE_LOG_MAX) &&
+           (p_cfg->receive_delay >= FRIENDSHIP_CFG_RECEIVE_DELAY_MIN) &&
+           (p_cfg->receive_delay <= FRIENDSHIP_CFG_RECEIVE_DELAY_MAX) &&
+           (p_cfg->poll_timeout >= FRIENDSHIP_CFG_POLL_TIMEOUT_MIN) &&
+           (p_cfg->poll_timeout <= FRIENDSHIP_CFG_POLL_TIMEOUT_MAX);
+#else
+    return (p_cfg->receive_window >= FRIENDSHIP_CFG_RECEIVE_WINDOW_MIN) &&
+           (p_cfg->cache_buf_len >= FRIENDSHIP_CFG_CACHE_BUF_LEN_MIN) &&
+           (p_cfg->cache_buf_len <= FRIENDSHIP_CFG_CACHE_BUF_LEN_MAX) &&
+           (p_cfg->max_lpn_num >= 1) &&
+           (p_cfg->max_lpn_num <= FRIENDSHIP_CFG_MAX_LPN_NUM_MAX);
+#endif
+}
+
+/*
+ * Copy the parameters of the node role to mesh_config
+ */
+static void friendship_cfg_apply(wiced_bool_t at_init)
+{
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    mesh_config.low_power.rssi_factor           = friendship_cfg.rssi_factor;
+    mesh_config.low_power.receive_window_factor = friendship_cfg.receive_window_factor;
+    mesh_config.low_power.min_cache_size_log    = friendship_cfg.min_cache_size_log;
+    mesh_config.low_power.receive_delay         = friendship_cfg.receive_delay;
+#ifdef COHORT
+    // The experiment cohort may use its own poll timeout
+    mesh_config.low_power.poll_timeout          = cohort_poll_timeout(friendship_cfg.poll_timeout);
+#else
+    mesh_config.low_power.poll_timeout          = friendship_cfg.poll_timeout;
+#endif
+#ifdef LPN_POLL_SPREAD
+    // The slot offsets are added to the new values, at init mesh_app_init spreads the poll
+    if (!at_init)
+        mesh_low_power_led_spread_poll(WICED_TRUE);
+#endif
+#else
+    mesh_config.friend_cfg.receive_window       = friendship_cfg.receive_window;
+    // The cache is allocated by the core at start up
+    if (at_init)
+    {
+        mesh_config.friend_cfg.cache_buf_len    = friendship_cfg.cache_buf_len;
+        mesh_config.friend_cfg.max_lpn_num      = friendship_cfg.max_lpn_num;
+    }
+#endif
+}
+
+/*
+ * Send Friendship Config Status with the parameters of the node role
+ */
+static void friendship_cfg_send_status(wiced_bt_mesh_event_t *p_event, uint8_t status)
+{
+    uint8_t buffer[FRIENDSHIP_CFG_STATUS_LEN];
+    uint8_t *p = buffer;
+
+    UINT8_TO_STREAM(p, status);
+    UINT8_TO_STREAM(p, FRIENDSHIP_CFG_ROLE);
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    UINT8_TO_STREAM(p, friendship_cfg.rssi_factor);
+    UINT8_TO_STREAM(p, friendship_cfg.receive_window_factor);
+    UINT8_TO_STREAM(p, friendship_cfg.min_cache_size_log);
+    UINT8_TO_STREAM(p, friendship_cfg.receive_delay);
+    UINT24_TO_STREAM(p, friendship_cfg.poll_timeout);
+#else
+    UINT8_TO_STREAM(p, friendship_cfg.receive_window);
+    UINT16_TO_STREAM(p, friendship_cfg.cache_buf_len);
+    UINT8_TO_STREAM(p, friendship_cfg.max_lpn_num);
+#endif
+    UINT8_TO_STREAM(p, friendship_cfg_flags);
+
+    mesh_low_power_led_vendor_send(wiced_bt_mesh_create_reply_event(p_event), MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_STATUS, buffer, (uint16_t)(p - buffer));
+}
+
+#endif // FRIENDSHIP_CFG
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Friendship parameters vendor configuration API definition
+ */
+
+#ifndef __FRIENDSHIP_CFG__H
+#define __FRIENDSHIP_CFG__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Role byte of the messages, a Set for the other role is rejected
+ */
+#define FRIENDSHIP_CFG_ROLE_FRIEND              0
+#define FRIENDSHIP_CFG_ROLE_LPN                 1
+
+/*
+ * Friendship Config Set parameters after the role, little endian
+ *   LPN: rssi_factor (1, 0-3), receive_window_factor (1, 0-3), min_cache_size_log (1, 1-7),
+ *        receive_delay in ms (1, 10-255), poll_timeout in 100 ms units (3, 0x0A-0x34BBFF)
+ *   friend: receive_window in ms (1, 1-255), cache_buf_len (2, 64-2048), max_lpn_num (1, 1-16)
+ * Friendship Config Status: status (1), role (1), the parameters in use (as above), flags (1)
+ */
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+#define FRIENDSHIP_CFG_ROLE                     FRIENDSHIP_CFG_ROLE_LPN
+#define FRIENDSHIP_CFG_PARAMS_LEN               (1 + 1 + 1 + 1 + 3)
+#else
+#define FRIENDSHIP_CFG_ROLE                     FRIENDSHIP_CFG_ROLE_FRIEND
+#define FRIENDSHIP_CFG_PARAMS_LEN               (1 + 2 + 1)
+#endif
+#define FRIENDSHIP_CFG_STATUS_LEN               (1 + 1 + FRIENDSHIP_CFG_PARAMS_LEN + 1)
+
+/*
+ * Status codes
+ */
+#define FRIENDSHIP_CFG_STATUS_SUCCESS           0
+#define FRIENDSHIP_CFG_STATUS_INVALID           1       // wrong length or role
+#define FRIENDSHIP_CFG_STATUS_OUT_OF_RANGE      2
+#define FRIENDSHIP_CFG_STATUS_NVRAM_FAILED      3
+
+/*
+ * Status flags
+ */
+#define FRIENDSHIP_CFG_FLAG_PENDING             0x01    // set since start up, used from the next friendship establishment
+#define FRIENDSHIP_CFG_FLAG_RESTART             0x02    // friend cache size changed, used after a restart
+
+/*
+ * Read the saved parameters and copy them to mesh_config
+ */
+void friendship_cfg_init(void);
+
+/*
+ * Process Friendship Config Get and Set
+ */
+void friendship_cfg_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
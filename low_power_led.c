@@ -68,19 +68,77 @@
 #include "wiced_platform.h"
 #include "wiced_timer.h"
 #include "led_control.h"
+#include "low_power_led.h"
+#include "low_power_led_vendor.h"
 #include "wiced_hal_nvram.h"
 #include "wiced_hal_mia.h"
 #if defined(NETWORK_FILTER_SERVER_SUPPORTED)
 #include "wiced_bt_mesh_mdf.h"
 #endif
+#ifdef SYNC_ACTUATION_SUPPORTED
+#include "sync_actuation.h"
+#endif
+#ifdef PREDICTIVE_POLL
+#include "predictive_poll.h"
+#endif
+#ifdef FRIEND_STATS
+#include "friend_stats.h"
+#endif
+#include "friend_cache_policy.h"
+#include "lpn_power_stats.h"
+#include "nvram_wear.h"
+#ifdef REPLAY_LIST
+#include "replay_list.h"
+#endif
+#ifdef NET_CACHE
+#include "net_cache.h"
+#endif
+#ifdef RELAY_PRUNE
+#include "relay_prune.h"
+#endif
+#ifdef ADAPTIVE_TX
+#include "adaptive_tx.h"
+#endif
+#ifdef DIRECTED_FWD
+#include "directed_fwd.h"
+#endif
+#ifdef PROXY_ON_DEMAND
+#include "proxy_on_demand.h"
+#endif
+#ifdef TX_SCHED
+#include "tx_sched.h"
+#endif
+#ifdef EXT_ADV_BEARER
+#include "ext_adv.h"
+#endif
+#ifdef CODED_PHY
+#include "coded_phy.h"
+#endif
+#ifdef STACK_STATS
+#include "stack_stats.h"
+#endif
+#ifdef POOL_STATS
+#include "pool_stats.h"
+#endif
+#ifdef FRIENDSHIP_CFG
+#include "friendship_cfg.h"
+#endif
+#ifdef COHORT
+#include "cohort.h"
+#endif
 
 
 #ifdef HCI_CONTROL
 #include "wiced_transport.h"
 #include "hci_control_api.h"
+#include "low_power_led_hci.h"
 #endif
 
 #include "wiced_bt_cfg.h"
+#ifdef LPN_POLL_MERGE
+#include "wiced.h"
+#include "clock_timer.h"
+#endif
 extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
 /******************************************************
@@ -91,6 +149,18 @@ extern wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
 
 #define TRANSITION_INTERVAL     100     // receive status notifications every 100ms during transition to new state
 
+#ifdef PREDICTIVE_POLL
+#define LPN_POLL_TIMEOUT        PREDICTIVE_POLL_POLL_TIMEOUT
+#else
+#define LPN_POLL_TIMEOUT        200
+#endif
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1) && defined(LPN_POLL_MERGE)
+// Local wake up (button, scheduled action) sends the poll early if the remaining time to the
+// scheduled poll is at most 1/LPN_POLL_MERGE_FRACTION of the sleep duration.
+#define LPN_POLL_MERGE_FRACTION             4
+#endif
+
 /******************************************************
  *          Structures
  ******************************************************/
@@ -106,6 +176,10 @@ typedef struct
 #define MESH_LPN_STATE_NOT_IDLE   0
 #define MESH_LPN_STATE_IDLE       1
     uint8_t                lpn_state;    // LPN state: IDLE or NOT_IDLE
+#ifdef LPN_POLL_MERGE
+    uint64_t               lpn_poll_due_us;     // time of the scheduled wake up, 0 if not scheduled
+    uint32_t               lpn_sleep_duration;  // duration of the current sleep in ms
+#endif
 #endif
 } mesh_low_power_led_t;
 
@@ -119,7 +193,26 @@ static void mesh_low_power_led_process_status(uint8_t element_idx, wiced_bt_mesh
 void mesh_low_power_led_lpn_sleep(uint32_t duration);
 static uint32_t mesh_low_power_led_sleep_poll(wiced_sleep_poll_type_t type);
 static void wakeup_timer_cb(TIMER_PARAM_TYPE arg);
-
+#if defined(LPN_EARLY_SLEEP) || defined(LPN_POWER_STATS) || defined(CODED_PHY) || defined(POOL_STATS)
+static wiced_bool_t mesh_low_power_led_lpn_event_cb(wiced_bt_mesh_core_lpn_event_t *p_event);
+#endif
+#if defined(LPN_POLL_MERGE) && (defined(CYW20819A1) || defined(CYW20820A1))
+static void mesh_low_power_led_post_sleep(wiced_bool_t restore_configuration);
+static int mesh_low_power_led_button_wake(void *p_data);
+#endif
+#endif
+#ifdef STACK_STATS
+static void mesh_low_power_led_message_handler_stack(uint8_t element_idx, uint16_t event, void *p_data);
+#ifdef HCI_CONTROL
+static uint32_t mesh_low_power_led_proc_rx_cmd_stack(uint16_t opcode, uint8_t *p_data, uint32_t length);
+#endif
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+static uint32_t mesh_low_power_led_sleep_poll_stack(wiced_sleep_poll_type_t type);
+static void wakeup_timer_cb_stack(TIMER_PARAM_TYPE arg);
+#if defined(LPN_EARLY_SLEEP) || defined(LPN_POWER_STATS) || defined(CODED_PHY) || defined(POOL_STATS)
+static wiced_bool_t mesh_low_power_led_lpn_event_cb_stack(wiced_bt_mesh_core_lpn_event_t *p_event);
+#endif
+#endif
 #endif
 
 /******************************************************
@@ -139,6 +232,9 @@ wiced_bt_mesh_core_config_model_t   mesh_element1_models[] =
 #endif
     WICED_BT_MESH_MODEL_USER_PROPERTY_SERVER,
     WICED_BT_MESH_MODEL_POWER_ONOFF_SERVER,
+#ifdef LOW_POWER_LED_VENDOR_MODEL_SUPPORTED
+    MESH_LOW_POWER_LED_VENDOR_MODEL,
+#endif
 };
 
 wiced_bt_mesh_core_config_property_t mesh_element1_properties[] =
@@ -154,8 +250,6 @@ wiced_bt_mesh_core_config_property_t mesh_element1_properties[] =
 #define MESH_APP_NUM_PROPERTIES (sizeof(mesh_element1_properties) / sizeof(wiced_bt_mesh_core_config_property_t))
 
 
-#define MESH_LOW_POWER_LED_ELEMENT_INDEX   0
-
 wiced_bt_mesh_core_config_element_t mesh_elements[] =
 {
     {
@@ -194,7 +288,7 @@ wiced_bt_mesh_core_config_t  mesh_config =
         .receive_window_factor = 2,                                 // contribution of the supported Receive Window used in Friend Offer Delay calculations.
         .min_cache_size_log    = 3,                                 // minimum number of messages that the Friend node can store in its Friend Cache.
         .receive_delay         = 100,                               // Receive delay in 1 ms units to be requested by the Low Power node.
-        .poll_timeout          = 200                                // Poll timeout in 100ms units to be requested by the Low Power node.
+        .poll_timeout          = LPN_POLL_TIMEOUT                   // Poll timeout in 100ms units to be requested by the Low Power node.
     },
 #else
     .features = WICED_BT_MESH_CORE_FEATURE_BIT_FRIEND | WICED_BT_MESH_CORE_FEATURE_BIT_RELAY | WICED_BT_MESH_CORE_FEATURE_BIT_GATT_PROXY_SERVER,   // Supports Friend, Relay and GATT Proxy
@@ -225,10 +319,20 @@ wiced_bt_mesh_app_func_table_t wiced_bt_mesh_app_func_table =
 {
     mesh_app_init,          // application initialization
     NULL,                   // Default SDK platform button processing
+#if defined(PROXY_ON_DEMAND) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    proxy_on_demand_conn_status, // GATT connection status
+#else
     NULL,                   // GATT connection status
+#endif
     NULL,                   // attention processing
     NULL,                   // notify period set
+#if defined(HCI_CONTROL) && defined(STACK_STATS)
+    mesh_low_power_led_proc_rx_cmd_stack, // WICED HCI command
+#elif defined(HCI_CONTROL)
+    mesh_low_power_led_proc_rx_cmd, // WICED HCI command
+#else
     NULL,                   // WICED HCI command
+#endif
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
     mesh_low_power_led_lpn_sleep,// LPN sleep
 #else
@@ -316,14 +420,91 @@ void mesh_app_init(wiced_bool_t is_provisioned)
 
     led_control_init(LED_CONTROL_TYPE_ONOFF);
 
+#ifdef FRIENDSHIP_CFG
+    // Before the modules which use the friendship parameters of mesh_config
+    friendship_cfg_init();
+#endif
+#ifdef COHORT
+    // After the friendship parameters, before the modules which change the poll timeout
+    cohort_init();
+#endif
+
 #ifdef NETWORK_FILTER_SERVER_SUPPORTED
     if (is_provisioned)
         wiced_bt_mesh_network_filter_init();
 #endif
 
+#ifdef STACK_STATS
+    wiced_bt_mesh_model_power_onoff_server_init(MESH_LOW_POWER_LED_ELEMENT_INDEX, mesh_low_power_led_message_handler_stack, TRANSITION_INTERVAL, is_provisioned);
+#else
     wiced_bt_mesh_model_power_onoff_server_init(MESH_LOW_POWER_LED_ELEMENT_INDEX, mesh_low_power_led_message_handler, TRANSITION_INTERVAL, is_provisioned);
+#endif
+
+#ifdef SYNC_ACTUATION_SUPPORTED
+    sync_actuation_init(is_provisioned);
+#endif
+
+#ifdef REPLAY_LIST
+    replay_list_init(is_provisioned);
+#endif
+
+#if defined(FRIEND_STATS) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    if (is_provisioned)
+        friend_stats_init();
+#endif
+#if (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)) && (FRIEND_CACHE_POLICY != FRIEND_CACHE_POLICY_DROP_OLDEST)
+    friend_cache_policy_init();
+#endif
+#if defined(NET_CACHE) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    net_cache_init();
+#endif
+#if defined(RELAY_PRUNE) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    if (is_provisioned)
+        relay_prune_init();
+#endif
+#if defined(ADAPTIVE_TX) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    if (is_provisioned)
+        adaptive_tx_init();
+#endif
+#if defined(DIRECTED_FWD) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    if (is_provisioned)
+        directed_fwd_init();
+#endif
+#if defined(PROXY_ON_DEMAND) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    // Also before provisioning, the GATT connection status callback is installed in both states
+    proxy_on_demand_init(is_provisioned);
+#endif
+#if defined(TX_SCHED) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    tx_sched_init();
+#endif
+#if defined(EXT_ADV_BEARER) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    if (is_provisioned)
+        ext_adv_init();
+#endif
+#ifdef CODED_PHY
+    coded_phy_init();
+#endif
+#ifdef POOL_STATS
+    pool_stats_init();
+#endif
 
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+#ifdef PREDICTIVE_POLL
+    predictive_poll_init(is_provisioned);
+#endif
+#if defined(LPN_EARLY_SLEEP) || defined(LPN_POWER_STATS) || defined(CODED_PHY)
+#ifdef STACK_STATS
+    wiced_bt_mesh_core_lpn_register_event_cb(mesh_low_power_led_lpn_event_cb_stack);
+#else
+    wiced_bt_mesh_core_lpn_register_event_cb(mesh_low_power_led_lpn_event_cb);
+#endif
+#endif
+#ifdef LPN_POLL_SPREAD
+    // Friendship parameters are used when the node sends Friend Request after provisioning
+    if (is_provisioned)
+        mesh_low_power_led_spread_poll(WICED_FALSE);
+#endif
+
     if (!do_not_init_again)
     {
         WICED_BT_TRACE("Init once \n");
@@ -334,9 +515,17 @@ void mesh_app_init(wiced_bool_t is_provisioned)
         app_state.lpn_sleep_config.device_wake_source = WICED_SLEEP_WAKE_SOURCE_GPIO;
         app_state.lpn_sleep_config.device_wake_gpio_num = WICED_GPIO_PIN_BUTTON;
         app_state.lpn_sleep_config.host_wake_mode = WICED_SLEEP_WAKE_ACTIVE_HIGH;
+#ifdef STACK_STATS
+        app_state.lpn_sleep_config.sleep_permit_handler = mesh_low_power_led_sleep_poll_stack;
+#else
         app_state.lpn_sleep_config.sleep_permit_handler = mesh_low_power_led_sleep_poll;
+#endif
 #if defined(CYW20819A1) || defined(CYW20820A1)
+#ifdef LPN_POLL_MERGE
+        app_state.lpn_sleep_config.post_sleep_cback_handler = mesh_low_power_led_post_sleep;
+#else
         app_state.lpn_sleep_config.post_sleep_cback_handler = NULL;
+#endif
 #endif
 
         if (WICED_BT_SUCCESS != wiced_sleep_configure(&app_state.lpn_sleep_config))
@@ -344,11 +533,20 @@ void mesh_app_init(wiced_bool_t is_provisioned)
             WICED_BT_TRACE("Sleep Configure failed\r\n");
         }
 
+#ifdef STACK_STATS
+        wiced_init_timer(&app_state.lpn_wake_timer, wakeup_timer_cb_stack, 0, WICED_MILLI_SECONDS_TIMER);
+#else
         wiced_init_timer(&app_state.lpn_wake_timer, wakeup_timer_cb, 0, WICED_MILLI_SECONDS_TIMER);
+#endif
 
         do_not_init_again = WICED_TRUE;
     }
 #endif
+
+#ifdef SEQ_BLOCK_SIZE
+    // Called last, the sequence number block size depends on the final poll timeout
+    nvram_wear_init(is_provisioned);
+#endif
 }
 
 /*
@@ -356,6 +554,12 @@ void mesh_app_init(wiced_bool_t is_provisioned)
  */
 void mesh_low_power_led_message_handler(uint8_t element_idx, uint16_t event, void *p_data)
 {
+#ifdef POOL_STATS
+    pool_stats_sample();
+#endif
+#ifdef COHORT
+    cohort_message();
+#endif
     switch (event)
     {
     case WICED_BT_MESH_ONOFF_STATUS:
@@ -372,7 +576,41 @@ void mesh_low_power_led_message_handler(uint8_t element_idx, uint16_t event, voi
  */
 void mesh_low_power_led_process_status(uint8_t element_idx, wiced_bt_mesh_onoff_status_data_t *p_status)
 {
-    led_control_set_onoff(p_status->present_onoff);
+#if defined(PREDICTIVE_POLL) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    // Every Set is recorded, also one which does not change the state. A transition reports its
+    // steps, the command is recorded once at the end.
+    if (p_status->remaining_time == 0)
+        predictive_poll_record_command();
+#endif
+    mesh_low_power_led_apply_onoff(p_status->present_onoff);
+}
+
+/*
+ * Set the LED state and remember it as the present state of the application
+ */
+void mesh_low_power_led_apply_onoff(uint8_t onoff)
+{
+    app_state.present_onoff = onoff;
+    app_state.target_onoff  = onoff;
+    led_control_set_onoff(onoff);
+}
+
+/*
+ * Change the state locally, for example at the target time of a synchronized command. The state of the
+ * Power OnOff server is updated as well, so that Generic OnOff Get and publications report the new state.
+ */
+void mesh_low_power_led_set_onoff(uint8_t onoff)
+{
+    wiced_bt_mesh_model_power_onoff_server_set_onoff(MESH_LOW_POWER_LED_ELEMENT_INDEX, onoff);
+    mesh_low_power_led_apply_onoff(onoff);
+}
+
+/*
+ * Returns present state of the LED
+ */
+uint8_t mesh_low_power_led_get_onoff(void)
+{
+    return app_state.present_onoff;
 }
 
 /*
@@ -381,6 +619,39 @@ void mesh_low_power_led_process_status(uint8_t element_idx, wiced_bt_mesh_onoff_
 #if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
 void mesh_low_power_led_lpn_sleep(uint32_t max_sleep_duration)
 {
+#ifdef POOL_STATS
+    // Once per poll cycle, without the poll cycle events of the core
+    pool_stats_sample();
+#endif
+#ifdef LPN_POWER_STATS
+    lpn_power_stats_sleep();
+#endif
+#ifdef COHORT
+    cohort_sleep();
+#endif
+#if !defined(CYW20835B1)
+    wiced_bool_t hid_off_allowed = WICED_TRUE;
+
+#ifdef SYNC_ACTUATION_SUPPORTED
+    // Timers do not run in HID-OFF, stay in ePDS until the synchronized action is applied
+    if (sync_actuation_time_to_action() != SYNC_ACTUATION_NO_ACTION)
+        hid_off_allowed = WICED_FALSE;
+#endif
+#endif
+
+#ifdef PREDICTIVE_POLL
+    if (max_sleep_duration != WICED_SLEEP_MAX_TIME_TO_SLEEP)
+        max_sleep_duration = predictive_poll_sleep_duration(max_sleep_duration);
+#endif
+
+#ifdef LPN_POLL_MERGE
+    // Wake up from HID-OFF is a reset, local wake ups can only be merged in ePDS
+    app_state.lpn_poll_due_us    = 0;
+    app_state.lpn_sleep_duration = max_sleep_duration;
+    if (max_sleep_duration != WICED_SLEEP_MAX_TIME_TO_SLEEP)
+        app_state.lpn_poll_due_us = clock_SystemTimeMicroseconds64() + (uint64_t)max_sleep_duration * 1000;
+#endif
+
 #if defined(CYW20835B1)
 	// Enter SDS (Shut Down Sleep) will save more power than PMU Sleep. But it's up to your design.
 	if(max_sleep_duration != WICED_SLEEP_MAX_TIME_TO_SLEEP)
@@ -392,7 +663,7 @@ void mesh_low_power_led_lpn_sleep(uint32_t max_sleep_duration)
 	app_state.lpn_state = MESH_LPN_STATE_IDLE;
 #else
 	// Generally speaking, if sleep timer bigger than 2mins, then hid-off will save more power. But it's up to your design.
-    if (max_sleep_duration < 120000)//2mins
+    if ((max_sleep_duration < 120000) || !hid_off_allowed)//2mins
     {
         wiced_stop_timer(&app_state.lpn_wake_timer);
         wiced_start_timer(&app_state.lpn_wake_timer, max_sleep_duration);
@@ -402,6 +673,16 @@ void mesh_low_power_led_lpn_sleep(uint32_t max_sleep_duration)
     else
     {
         WICED_BT_TRACE("Entering HID-OFF for max_sleep_duration: %d\r\n", max_sleep_duration);
+        // RAM is not retained in HID-OFF
+#ifdef PREDICTIVE_POLL
+        predictive_poll_save();
+#endif
+#ifdef REPLAY_LIST
+        replay_list_flush();
+#endif
+#ifdef COHORT
+        cohort_save(max_sleep_duration);
+#endif
         if (WICED_SUCCESS != wiced_sleep_enter_hid_off(max_sleep_duration, WICED_GPIO_PIN_BUTTON, 1))
         {
             WICED_BT_TRACE("Entering HID-Off failed\n\r");
@@ -419,8 +700,133 @@ static void wakeup_timer_cb(TIMER_PARAM_TYPE arg)
     WICED_BT_TRACE("ePDS wake up!!!\n");
     app_state.lpn_state = MESH_LPN_STATE_NOT_IDLE;
     wiced_stop_timer(&app_state.lpn_wake_timer);
+#ifdef LPN_POWER_STATS
+    lpn_power_stats_wake();
+#endif
+#ifdef COHORT
+    cohort_wake();
+#endif
+
+#ifdef SYNC_ACTUATION_SUPPORTED
+    sync_actuation_lpn_wake();
+#endif
+#ifdef PREDICTIVE_POLL
+    predictive_poll_wake();
+#endif
+}
+
+#if defined(LPN_EARLY_SLEEP) || defined(LPN_POWER_STATS) || defined(CODED_PHY) || defined(POOL_STATS)
+/*
+ * Poll cycle event of the mesh core, registered with wiced_bt_mesh_core_lpn_register_event_cb.
+ * The hook is an assumed extension of the mesh core, the prebuilt core does not report poll
+ * cycle events. Coded PHY selection sees every event.
+ * On a response without more data the friend cache is empty, returning WICED_TRUE closes the
+ * receive window and the core calls mesh_low_power_led_lpn_sleep from the receive path instead
+ * of at the end of the window.
+ */
+static wiced_bool_t mesh_low_power_led_lpn_event_cb(wiced_bt_mesh_core_lpn_event_t *p_event)
+{
+    wiced_bool_t early_sleep = WICED_FALSE;
+
+#ifdef CODED_PHY
+    coded_phy_lpn_event(p_event);
+#endif
+    if (p_event->type != WICED_BT_MESH_CORE_LPN_EVENT_RESPONSE)
+        return WICED_FALSE;
+
+#ifdef LPN_EARLY_SLEEP
+    early_sleep = !p_event->more_data;
+#ifdef COHORT
+    early_sleep = early_sleep && cohort_early_sleep();
+#endif
+#endif
+#ifdef LPN_POWER_STATS
+    lpn_power_stats_response(p_event->update, p_event->more_data, early_sleep);
+#endif
+    return early_sleep;
 }
+#endif
+
+#ifdef LPN_POLL_MERGE
+/*
+ * Called when the node wakes up for a local reason, a button press or a scheduled action. If the
+ * scheduled poll is close, poll the friend now instead of waking up again shortly afterwards.
+ * Core restarts the poll timer after the poll and calls mesh_low_power_led_lpn_sleep again.
+ * wiced_bt_mesh_core_lpn_send_poll is an assumed extension of the mesh core API.
+ */
+void mesh_low_power_led_local_wake(void)
+{
+    uint64_t now_us;
+    uint64_t remaining_ms;
 
+    // Poll is in progress or the wake up is not scheduled
+    if ((app_state.lpn_state != MESH_LPN_STATE_IDLE) || (app_state.lpn_poll_due_us == 0))
+        return;
+
+    now_us = clock_SystemTimeMicroseconds64();
+    remaining_ms = (now_us < app_state.lpn_poll_due_us) ? (app_state.lpn_poll_due_us - now_us) / 1000 : 0;
+    if (remaining_ms * LPN_POLL_MERGE_FRACTION > app_state.lpn_sleep_duration)
+        return;
+
+    WICED_BT_TRACE("merge poll, %d ms early\n", (uint32_t)remaining_ms);
+    app_state.lpn_poll_due_us = 0;
+    app_state.lpn_state = MESH_LPN_STATE_NOT_IDLE;
+    wiced_stop_timer(&app_state.lpn_wake_timer);
+#ifdef LPN_POWER_STATS
+    lpn_power_stats_wake();
+#endif
+#ifdef COHORT
+    cohort_wake();
+#endif
+    wiced_bt_mesh_core_lpn_send_poll();
+}
+
+#if defined(CYW20819A1) || defined(CYW20820A1)
+/*
+ * Called on wake up from ePDS. Mesh core can not be used in this context, the button wake up
+ * is passed to the application thread.
+ */
+static void mesh_low_power_led_post_sleep(wiced_bool_t restore_configuration)
+{
+    if (wiced_hal_gpio_get_pin_interrupt_status(WICED_GPIO_PIN_BUTTON))
+        wiced_app_event_serialize(mesh_low_power_led_button_wake, NULL);
+}
+
+static int mesh_low_power_led_button_wake(void *p_data)
+{
+    mesh_low_power_led_local_wake();
+    return 0;
+}
+#endif
+#endif
+
+
+#ifdef LPN_POLL_SPREAD
+/*
+ * Select receive delay and poll timeout slot based on the unicast address. Consecutive addresses
+ * assigned by the provisioner end up in different slots. new_base is WICED_TRUE when mesh_config
+ * holds newly configured values instead of the values of the previous spread.
+ */
+void mesh_low_power_led_spread_poll(wiced_bool_t new_base)
+{
+    static uint8_t  base_receive_delay = 0;
+    static uint32_t base_poll_timeout  = 0;
+    uint16_t        slot;
+
+    // Remember configured values, the function is called on every init
+    if ((base_poll_timeout == 0) || new_base)
+    {
+        base_receive_delay = mesh_config.low_power.receive_delay;
+        base_poll_timeout  = mesh_config.low_power.poll_timeout;
+    }
+    slot = wiced_bt_mesh_core_get_local_addr() % LPN_POLL_SPREAD_SLOTS;
+
+    mesh_config.low_power.receive_delay = base_receive_delay + slot * LPN_POLL_SPREAD_RECEIVE_DELAY_STEP;
+    mesh_config.low_power.poll_timeout  = base_poll_timeout + slot * LPN_POLL_SPREAD_POLL_TIMEOUT_STEP;
+
+    WICED_BT_TRACE("poll spread slot:%d receive_delay:%d poll_timeout:%d\n", slot, mesh_config.low_power.receive_delay, mesh_config.low_power.poll_timeout);
+}
+#endif
 
 /*
  * Sleep permission polling time to be used by firmware
@@ -459,3 +865,59 @@ static uint32_t mesh_low_power_led_sleep_poll(wiced_sleep_poll_type_t type)
     return ret;
 }
 #endif
+
+#ifdef STACK_STATS
+/*
+ * Callbacks registered with the system in the STACK_STATS build, each one records the stack
+ * used by the callback it calls.
+ */
+static void mesh_low_power_led_message_handler_stack(uint8_t element_idx, uint16_t event, void *p_data)
+{
+    stack_stats_enter(STACK_STATS_CB_MESSAGE_HANDLER);
+    mesh_low_power_led_message_handler(element_idx, event, p_data);
+    stack_stats_exit(STACK_STATS_CB_MESSAGE_HANDLER);
+}
+
+#ifdef HCI_CONTROL
+static uint32_t mesh_low_power_led_proc_rx_cmd_stack(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    uint32_t ret;
+
+    stack_stats_enter(STACK_STATS_CB_HCI_COMMAND);
+    ret = mesh_low_power_led_proc_rx_cmd(opcode, p_data, length);
+    stack_stats_exit(STACK_STATS_CB_HCI_COMMAND);
+    return ret;
+}
+#endif
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+static uint32_t mesh_low_power_led_sleep_poll_stack(wiced_sleep_poll_type_t type)
+{
+    uint32_t ret;
+
+    stack_stats_enter(STACK_STATS_CB_SLEEP_POLL);
+    ret = mesh_low_power_led_sleep_poll(type);
+    stack_stats_exit(STACK_STATS_CB_SLEEP_POLL);
+    return ret;
+}
+
+static void wakeup_timer_cb_stack(TIMER_PARAM_TYPE arg)
+{
+    stack_stats_enter(STACK_STATS_CB_WAKEUP_TIMER);
+    wakeup_timer_cb(arg);
+    stack_stats_exit(STACK_STATS_CB_WAKEUP_TIMER);
+}
+
+#if defined(LPN_EARLY_SLEEP) || defined(LPN_POWER_STATS) || defined(CODED_PHY) || defined(POOL_STATS)
+static wiced_bool_t mesh_low_power_led_lpn_event_cb_stack(wiced_bt_mesh_core_lpn_event_t *p_event)
+{
+    wiced_bool_t ret;
+
+    stack_stats_enter(STACK_STATS_CB_LPN_EVENT);
+    ret = mesh_low_power_led_lpn_event_cb(p_event);
+    stack_stats_exit(STACK_STATS_CB_LPN_EVENT);
+    return ret;
+}
+#endif
+#endif
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Low Power LED application shared definitions
+ */
+
+#ifndef __LOW_POWER_LED__H
+#define __LOW_POWER_LED__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "wiced_hal_nvram.h"
+
+#define MESH_LOW_POWER_LED_ELEMENT_INDEX   0
+
+/*
+ * NVRAM IDs used by the application. Mesh core and mesh_app_lib allocate their IDs
+ * from the beginning of the VS ID range, the application uses the end of the range.
+ */
+#define LOW_POWER_LED_NVRAM_ID_SYNC_ACTUATION   (WICED_NVRAM_VSID_END - 1)
+#define LOW_POWER_LED_NVRAM_ID_PREDICTIVE_POLL  (WICED_NVRAM_VSID_END - 2)
+#define LOW_POWER_LED_NVRAM_ID_REPLAY_LIST      (WICED_NVRAM_VSID_END - 34)     // 32 records, up to WICED_NVRAM_VSID_END - 3
+#define LOW_POWER_LED_NVRAM_ID_FRIENDSHIP_CFG   (WICED_NVRAM_VSID_END - 35)
+#define LOW_POWER_LED_NVRAM_ID_COHORT           (WICED_NVRAM_VSID_END - 36)
+
+/*
+ * Set the LED state and remember it as the present state of the application
+ */
+void mesh_low_power_led_apply_onoff(uint8_t onoff);
+
+/*
+ * Change the state locally, the Power OnOff server state is updated as well
+ */
+void mesh_low_power_led_set_onoff(uint8_t onoff);
+
+/*
+ * Returns present state of the LED
+ */
+uint8_t mesh_low_power_led_get_onoff(void);
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1) && defined(LPN_POLL_MERGE)
+/*
+ * Called when the low power node wakes up for a local reason. Polls the friend
+ * if the scheduled poll is close.
+ */
+void mesh_low_power_led_local_wake(void);
+#endif
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1) && defined(LPN_POLL_SPREAD)
+// Low power nodes sharing a friend spread their polls using the unicast address. Each slot uses
+// slightly different receive delay and poll timeout, so that friend responses do not collide and
+// nodes which started at the same time drift apart instead of polling in lock step.
+#define LPN_POLL_SPREAD_SLOTS               8       // number of different receive delay / poll timeout values
+#define LPN_POLL_SPREAD_RECEIVE_DELAY_STEP  10      // receive delay difference between slots in ms
+#define LPN_POLL_SPREAD_POLL_TIMEOUT_STEP   1       // poll timeout difference between slots in 100 ms units
+
+/*
+ * Add the receive delay and poll timeout offsets of the node slot to mesh_config. new_base is
+ * WICED_TRUE when mesh_config holds newly configured values.
+ */
+void mesh_low_power_led_spread_poll(wiced_bool_t new_base);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
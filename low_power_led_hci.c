@@ -0,0 +1,241 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Low Power LED application specific WICED HCI commands. Commands which are not handled
+ * here are processed by the mesh_app_lib.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_transport.h"
+#include "hci_control_api.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#ifdef FRIEND_STATS
+#include "friend_stats.h"
+#endif
+#ifdef LPN_POWER_STATS
+#include "lpn_power_stats.h"
+#endif
+#include "nvram_wear.h"
+#ifdef REPLAY_LIST
+#include "replay_list.h"
+#endif
+#ifdef NET_CACHE
+#include "net_cache.h"
+#endif
+#ifdef RELAY_PRUNE
+#include "relay_prune.h"
+#endif
+#ifdef ADAPTIVE_TX
+#include "adaptive_tx.h"
+#endif
+#ifdef DIRECTED_FWD
+#include "directed_fwd.h"
+#endif
+#ifdef PROXY_ON_DEMAND
+#include "proxy_on_demand.h"
+#endif
+#ifdef TX_SCHED
+#include "tx_sched.h"
+#endif
+#ifdef EXT_ADV_BEARER
+#include "ext_adv.h"
+#endif
+#ifdef CODED_PHY
+#include "coded_phy.h"
+#endif
+#ifdef STACK_STATS
+#include "stack_stats.h"
+#endif
+#ifdef POOL_STATS
+#include "pool_stats.h"
+#endif
+#ifdef COHORT
+#include "cohort.h"
+#endif
+
+#ifdef HCI_CONTROL
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Process WICED HCI command received from the host. Returns WICED_TRUE if the command is handled by the application.
+ */
+uint32_t mesh_low_power_led_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length)
+{
+    switch (opcode)
+    {
+#if defined(FRIEND_STATS) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_FRIEND_STATS_GET:
+        friend_stats_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_FRIEND_STATS_RESET:
+        friend_stats_reset();
+        break;
+#endif
+#if defined(LPN_POWER_STATS) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_LPN_POWER_STATS_GET:
+        lpn_power_stats_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_LPN_POWER_STATS_RESET:
+        lpn_power_stats_reset();
+        break;
+#endif
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_NVRAM_STATS_GET:
+        nvram_wear_hci_send();
+        break;
+
+#ifdef REPLAY_LIST
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_REPLAY_LIST_STATS_GET:
+        replay_list_hci_send();
+        break;
+#endif
+
+#if defined(NET_CACHE) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_NET_CACHE_STATS_GET:
+        net_cache_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_NET_CACHE_STATS_RESET:
+        net_cache_reset_stats();
+        break;
+#endif
+
+#if defined(RELAY_PRUNE) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_RELAY_PRUNE_STATS_GET:
+        relay_prune_hci_send();
+        break;
+#endif
+
+#if defined(ADAPTIVE_TX) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_ADAPTIVE_TX_STATS_GET:
+        adaptive_tx_hci_send();
+        break;
+#endif
+
+#if defined(DIRECTED_FWD) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_DIRECTED_FWD_STATS_GET:
+        directed_fwd_hci_send();
+        break;
+#endif
+
+#if defined(PROXY_ON_DEMAND) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_PROXY_ADV_START:
+        proxy_on_demand_start(PROXY_ON_DEMAND_TRIGGER_HOST, (length >= 2) ? (uint16_t)(p_data[0] | (p_data[1] << 8)) : 0);
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_PROXY_STATS_GET:
+        proxy_on_demand_hci_send();
+        break;
+#endif
+
+#if defined(TX_SCHED) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_TX_SCHED_STATS_GET:
+        tx_sched_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_TX_SCHED_STATS_RESET:
+        tx_sched_reset_stats();
+        break;
+#endif
+
+#if defined(EXT_ADV_BEARER) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_EXT_ADV_STATS_GET:
+        ext_adv_hci_send();
+        break;
+#endif
+
+#if defined(CODED_PHY) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_CODED_PHY_STATS_GET:
+        coded_phy_hci_send();
+        break;
+#endif
+
+#ifdef STACK_STATS
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_STACK_STATS_GET:
+        stack_stats_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_STACK_STATS_RESET:
+        stack_stats_reset();
+        break;
+#endif
+
+#ifdef POOL_STATS
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_POOL_STATS_GET:
+        pool_stats_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_POOL_STATS_RESET:
+        pool_stats_reset();
+        break;
+#endif
+
+#ifdef COHORT
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_COHORT_STATS_GET:
+        cohort_hci_send();
+        break;
+
+    case HCI_CONTROL_LOW_POWER_LED_COMMAND_COHORT_STATS_RESET:
+        cohort_reset();
+        break;
+#endif
+
+    default:
+        return WICED_FALSE;
+    }
+    return WICED_TRUE;
+}
+
+/*
+ * Send WICED HCI event to the host
+ */
+void mesh_low_power_led_hci_send(uint16_t opcode, uint8_t *p_data, uint16_t length)
+{
+    if (wiced_transport_send_data(opcode, p_data, length) != WICED_SUCCESS)
+    {
+        WICED_BT_TRACE("hci send opcode:%04x failed\n", opcode);
+    }
+}
+
+#endif // HCI_CONTROL
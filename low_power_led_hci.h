@@ -0,0 +1,105 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Low Power LED WICED HCI commands and events
+ */
+
+#ifndef __LOW_POWER_LED_HCI__H
+#define __LOW_POWER_LED_HCI__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Application specific group of WICED HCI commands and events
+ */
+#define HCI_CONTROL_GROUP_LOW_POWER_LED                             0xE0
+
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_FRIEND_STATS_GET          ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x01)  // Read per LPN statistics of the friend
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_FRIEND_STATS_RESET        ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x02)  // Clear per LPN statistics of the friend
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_LPN_POWER_STATS_GET       ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x03)  // Read poll cycle power statistics of the LPN
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_LPN_POWER_STATS_RESET     ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x04)  // Clear poll cycle power statistics of the LPN
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_NVRAM_STATS_GET           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x05)  // Read NVRAM write statistics and flash lifetime projection
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_REPLAY_LIST_STATS_GET     ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x06)  // Read replay protection list statistics
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_NET_CACHE_STATS_GET       ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x07)  // Read relay network message cache statistics
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_NET_CACHE_STATS_RESET     ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x08)  // Clear relay network message cache statistics
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_RELAY_PRUNE_STATS_GET     ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x09)  // Read relay pruning density estimate and counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_ADAPTIVE_TX_STATS_GET     ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x0A)  // Read adaptive retransmit count and counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_DIRECTED_FWD_STATS_GET    ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x0B)  // Read directed forwarding path counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_PROXY_ADV_START           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x0C)  // Enable GATT proxy advertising for a window
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_PROXY_STATS_GET           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x0D)  // Read on-demand proxy advertising counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_TX_SCHED_STATS_GET        ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x0E)  // Read transmit scheduler queue depth and latency per class
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_TX_SCHED_STATS_RESET      ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x0F)  // Clear transmit scheduler statistics
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_EXT_ADV_STATS_GET         ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x10)  // Read extended advertising bearer counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_CODED_PHY_STATS_GET       ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x11)  // Read LPN poll PHY selection counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_STACK_STATS_GET           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x12)  // Read stack high-water marks per thread and callback
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_STACK_STATS_RESET         ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x13)  // Clear stack high-water marks
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_POOL_STATS_GET            ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x14)  // Read buffer pool usage
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_POOL_STATS_RESET          ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x15)  // Clear buffer pool exhaustion counters
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_COHORT_STATS_GET          ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x16)  // Read experiment cohort and its statistics
+#define HCI_CONTROL_LOW_POWER_LED_COMMAND_COHORT_STATS_RESET        ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x17)  // Clear cohort statistics
+
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_FRIEND_STATS                ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x81)  // Statistics of one LPN, sent for each LPN
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_LPN_POWER_STATS             ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x82)  // Poll cycle power statistics of the LPN
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_NVRAM_STATS                 ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x83)  // NVRAM write statistics and flash lifetime projection
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_REPLAY_LIST_STATS           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x84)  // Replay protection list statistics
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_NET_CACHE_STATS             ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x85)  // Relay network message cache statistics
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_RELAY_PRUNE_STATS           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x86)  // Relay pruning density estimate and counters
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_ADAPTIVE_TX_STATS           ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x87)  // Adaptive retransmit count and counters
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_DIRECTED_FWD_STATS          ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x88)  // Directed forwarding path counters
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_PROXY_STATS                 ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x89)  // On-demand proxy advertising counters
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_TX_SCHED_STATS              ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x8A)  // Transmit scheduler queue depth and latency per class
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_EXT_ADV_STATS               ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x8B)  // Extended advertising bearer counters
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_CODED_PHY_STATS             ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x8C)  // LPN poll PHY selection counters
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_STACK_STATS                 ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x8D)  // Stack high-water marks per thread and callback
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_POOL_STATS                  ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x8E)  // Buffer pool usage
+#define HCI_CONTROL_LOW_POWER_LED_EVENT_COHORT_STATS                ((HCI_CONTROL_GROUP_LOW_POWER_LED << 8) | 0x8F)  // Experiment cohort and its statistics
+
+/*
+ * Process WICED HCI command received from the host. Returns WICED_TRUE if the command is handled by the application.
+ */
+uint32_t mesh_low_power_led_proc_rx_cmd(uint16_t opcode, uint8_t *p_data, uint32_t length);
+
+/*
+ * Send WICED HCI event to the host
+ */
+void mesh_low_power_led_hci_send(uint16_t opcode, uint8_t *p_data, uint16_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
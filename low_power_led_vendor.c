@@ -0,0 +1,191 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Low Power LED vendor model. The model carries application specific messages,
+ * each message is processed by the application module that owns it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "low_power_led.h"
+#include "low_power_led_vendor.h"
+#ifdef SYNC_ACTUATION_SUPPORTED
+#include "sync_actuation.h"
+#endif
+#ifdef FRIEND_STATS
+#include "friend_stats.h"
+#endif
+#ifdef FRIENDSHIP_CFG
+#include "friendship_cfg.h"
+#endif
+#ifdef COHORT
+#include "cohort.h"
+#endif
+
+#ifdef LOW_POWER_LED_VENDOR_MODEL_SUPPORTED
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static wiced_bool_t mesh_low_power_led_vendor_opcode_supported(uint16_t opcode);
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Process vendor model message received from the mesh core
+ */
+wiced_bool_t mesh_low_power_led_vendor_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    // 0xffff model_id means request to check if that opcode belongs to that model
+    if (p_event->model_id == 0xffff)
+    {
+        if ((p_event->company_id != MESH_LOW_POWER_LED_VENDOR_COMPANY_ID) || !mesh_low_power_led_vendor_opcode_supported(p_event->opcode))
+            return WICED_FALSE;
+
+        p_event->model_id = MESH_LOW_POWER_LED_VENDOR_MODEL_ID;
+        return WICED_TRUE;
+    }
+
+    WICED_BT_TRACE("vendor msg src:%04x op:%d len:%d\n", p_event->src, p_event->opcode, data_len);
+
+    switch (p_event->opcode)
+    {
+#ifdef SYNC_ACTUATION_SUPPORTED
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_GET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_SET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_STATUS:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET_UNACKED:
+        // the module takes ownership of the p_event
+        sync_actuation_process_vendor_msg(p_event, p_data, data_len);
+        break;
+#endif
+#if defined(FRIEND_STATS) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIEND_STATS_GET:
+        friend_stats_process_vendor_msg(p_event, p_data, data_len);
+        break;
+#endif
+#ifdef FRIENDSHIP_CFG
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_GET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_SET:
+        friendship_cfg_process_vendor_msg(p_event, p_data, data_len);
+        break;
+#endif
+#ifdef COHORT
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_GET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_SET:
+        cohort_process_vendor_msg(p_event, p_data, data_len);
+        break;
+#endif
+
+    default:
+        wiced_bt_mesh_release_event(p_event);
+        return WICED_FALSE;
+    }
+    return WICED_TRUE;
+}
+
+/*
+ * Send vendor model message. The p_event is released by the core.
+ */
+void mesh_low_power_led_vendor_send(wiced_bt_mesh_event_t *p_event, uint8_t opcode, uint8_t *p_data, uint16_t data_len)
+{
+    wiced_result_t result;
+
+    p_event->opcode = opcode;
+
+    result = wiced_bt_mesh_core_send(p_event, p_data, data_len, NULL);
+    if (result != WICED_BT_SUCCESS)
+    {
+        WICED_BT_TRACE("vendor send op:%d failed:%d\n", opcode, result);
+    }
+}
+
+/*
+ * Send vendor model message to a specific destination
+ */
+void mesh_low_power_led_vendor_send_to(uint16_t dst, uint16_t app_key_idx, uint8_t opcode, uint8_t *p_data, uint16_t data_len)
+{
+    wiced_bt_mesh_event_t *p_event;
+
+    p_event = wiced_bt_mesh_create_event(MESH_LOW_POWER_LED_ELEMENT_INDEX, MESH_LOW_POWER_LED_VENDOR_COMPANY_ID, MESH_LOW_POWER_LED_VENDOR_MODEL_ID, dst, app_key_idx);
+    if (p_event == NULL)
+    {
+        WICED_BT_TRACE("vendor send op:%d no mem\n", opcode);
+        return;
+    }
+    mesh_low_power_led_vendor_send(p_event, opcode, p_data, data_len);
+}
+
+/*
+ * Check if the opcode is processed by the application
+ */
+static wiced_bool_t mesh_low_power_led_vendor_opcode_supported(uint16_t opcode)
+{
+    switch (opcode)
+    {
+#ifdef SYNC_ACTUATION_SUPPORTED
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_GET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_SET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_STATUS:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET_UNACKED:
+        return WICED_TRUE;
+#endif
+#if defined(FRIEND_STATS) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIEND_STATS_GET:
+        return WICED_TRUE;
+#endif
+#ifdef FRIENDSHIP_CFG
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_GET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_SET:
+        return WICED_TRUE;
+#endif
+#ifdef COHORT
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_GET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_SET:
+        return WICED_TRUE;
+#endif
+    default:
+        break;
+    }
+    return WICED_FALSE;
+}
+
+#endif // LOW_POWER_LED_VENDOR_MODEL_SUPPORTED
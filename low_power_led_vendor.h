@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Low Power LED vendor model definitions
+ */
+
+#ifndef __LOW_POWER_LED_VENDOR__H
+#define __LOW_POWER_LED_VENDOR__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The vendor model is added to the element only if one of the features using it is enabled
+ */
+#if defined(SYNC_ACTUATION_SUPPORTED) || defined(FRIEND_STATS) || defined(FRIENDSHIP_CFG) || defined(COHORT)
+#define LOW_POWER_LED_VENDOR_MODEL_SUPPORTED
+#endif
+
+#define MESH_LOW_POWER_LED_VENDOR_COMPANY_ID    MESH_COMPANY_ID_CYPRESS
+#define MESH_LOW_POWER_LED_VENDOR_MODEL_ID      0x0010
+
+/*
+ * Vendor model opcodes. Core adds company ID to make 3 byte vendor opcode.
+ */
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_GET                   0x01    // Request current time from a time master
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_SET                   0x02    // Time master distributes its time, no ack
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_STATUS                0x03    // Reply to the Time Get
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET             0x04    // Set OnOff state at absolute time, ack is required
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET_UNACKED     0x05    // Set OnOff state at absolute time, no ack
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_STATUS          0x06    // Reply to the Synchronized OnOff Set
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIEND_STATS_GET           0x07    // Read friend statistics of one LPN
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIEND_STATS_STATUS        0x08    // Reply to the Friend Stats Get
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_GET         0x09    // Read friendship parameters of the node role
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_SET         0x0A    // Set friendship parameters, ack is required
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_FRIENDSHIP_CFG_STATUS      0x0B    // Reply to the Friendship Config Get and Set
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_GET                 0x0C    // Read the experiment cohort and its statistics
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_SET                 0x0D    // Assign the experiment cohort, ack is required
+#define MESH_LOW_POWER_LED_VENDOR_OPCODE_COHORT_STATUS              0x0E    // Reply to the Cohort Get and Set
+
+#define MESH_LOW_POWER_LED_VENDOR_MODEL \
+    { MESH_LOW_POWER_LED_VENDOR_COMPANY_ID, MESH_LOW_POWER_LED_VENDOR_MODEL_ID, mesh_low_power_led_vendor_message_handler, NULL, NULL }
+
+/*
+ * Process vendor model message received from the mesh core
+ */
+wiced_bool_t mesh_low_power_led_vendor_message_handler(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+/*
+ * Send vendor model message. The p_event is released by the core.
+ */
+void mesh_low_power_led_vendor_send(wiced_bt_mesh_event_t *p_event, uint8_t opcode, uint8_t *p_data, uint16_t data_len);
+
+/*
+ * Send vendor model message to a specific destination
+ */
+void mesh_low_power_led_vendor_send_to(uint16_t dst, uint16_t app_key_idx, uint8_t opcode, uint8_t *p_data, uint16_t data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
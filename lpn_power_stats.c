@@ -0,0 +1,173 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Low power node poll cycle power statistics. Most polls find nothing in the friend cache,
+ * so the time the node stays awake for such an idle poll dominates the average current.
+ * The time from the wake up to the request to sleep is accumulated separately for idle
+ * polls and for polls which received messages, the average can be read over WICED HCI.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "lpn_power_stats.h"
+
+#if defined(LPN_POWER_STATS) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint64_t        wake_us;                    // start of the current poll cycle, 0 if asleep
+    uint8_t         responses;                  // responses received in the current poll cycle
+    wiced_bool_t    idle;                       // only a Friend Update without more data received
+
+    uint32_t        idle_polls;
+    uint64_t        idle_awake_us;
+    uint32_t        idle_awake_max_us;
+    uint32_t        other_polls;                // messages received or no response
+    uint64_t        other_awake_us;
+    uint32_t        early_sleeps;               // receive window closed after the response
+} lpn_power_stats_t;
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static lpn_power_stats_t lpn_power_stats = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Start of a poll cycle, the node woke up to poll the friend
+ */
+void lpn_power_stats_wake(void)
+{
+    lpn_power_stats.wake_us   = clock_SystemTimeMicroseconds64();
+    lpn_power_stats.responses = 0;
+    lpn_power_stats.idle      = WICED_FALSE;
+}
+
+/*
+ * Response received from the friend. update is set if the response is a Friend Update.
+ */
+void lpn_power_stats_response(wiced_bool_t update, wiced_bool_t more_data, wiced_bool_t early_sleep)
+{
+    if (lpn_power_stats.wake_us == 0)
+        return;
+
+    lpn_power_stats.idle = (lpn_power_stats.responses == 0) && update && !more_data;
+    lpn_power_stats.responses++;
+    if (early_sleep)
+        lpn_power_stats.early_sleeps++;
+}
+
+/*
+ * End of a poll cycle, the node goes to sleep
+ */
+void lpn_power_stats_sleep(void)
+{
+    uint32_t awake_us;
+
+    if (lpn_power_stats.wake_us == 0)
+        return;
+
+    awake_us = (uint32_t)(clock_SystemTimeMicroseconds64() - lpn_power_stats.wake_us);
+    lpn_power_stats.wake_us = 0;
+
+    if (lpn_power_stats.idle)
+    {
+        lpn_power_stats.idle_polls++;
+        lpn_power_stats.idle_awake_us += awake_us;
+        if (awake_us > lpn_power_stats.idle_awake_max_us)
+            lpn_power_stats.idle_awake_max_us = awake_us;
+    }
+    else
+    {
+        lpn_power_stats.other_polls++;
+        lpn_power_stats.other_awake_us += awake_us;
+    }
+}
+
+/*
+ * Clear the statistics
+ */
+void lpn_power_stats_reset(void)
+{
+    memset(&lpn_power_stats, 0, sizeof(lpn_power_stats));
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t lpn_power_stats_serialize(uint8_t *p_buffer)
+{
+    uint8_t  *p = p_buffer;
+    uint32_t  idle_average_us = 0;
+
+    if (lpn_power_stats.idle_polls != 0)
+        idle_average_us = (uint32_t)(lpn_power_stats.idle_awake_us / lpn_power_stats.idle_polls);
+
+    UINT32_TO_STREAM(p, lpn_power_stats.idle_polls);
+    UINT32_TO_STREAM(p, (uint32_t)(lpn_power_stats.idle_awake_us / 1000));
+    UINT32_TO_STREAM(p, idle_average_us);
+    UINT32_TO_STREAM(p, lpn_power_stats.idle_awake_max_us);
+    UINT32_TO_STREAM(p, lpn_power_stats.other_polls);
+    UINT32_TO_STREAM(p, (uint32_t)(lpn_power_stats.other_awake_us / 1000));
+    UINT32_TO_STREAM(p, lpn_power_stats.early_sleeps);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void lpn_power_stats_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t  buffer[LPN_POWER_STATS_RECORD_LEN];
+
+    WICED_BT_TRACE("idle polls:%d awake avg:%d us\n", lpn_power_stats.idle_polls,
+            lpn_power_stats.idle_polls ? (uint32_t)(lpn_power_stats.idle_awake_us / lpn_power_stats.idle_polls) : 0);
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_LPN_POWER_STATS, buffer, lpn_power_stats_serialize(buffer));
+#endif
+}
+
+#endif // LPN_POWER_STATS && LOW_POWER_NODE
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Low power node poll cycle power statistics API definition
+ */
+
+#ifndef __LPN_POWER_STATS__H
+#define __LPN_POWER_STATS__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   idle polls (4), idle awake sum ms (4), idle awake average us (4), idle awake max us (4),
+ *   other polls (4), other awake sum ms (4), early sleeps (4)
+ * An idle poll is a poll cycle in which the friend answered with a Friend Update without
+ * more data. Awake time is measured from the wake up to the request to sleep.
+ */
+#define LPN_POWER_STATS_RECORD_LEN          (4 * 7)
+
+/*
+ * Start of a poll cycle, the node woke up to poll the friend
+ */
+void lpn_power_stats_wake(void);
+
+/*
+ * Response received from the friend. update is set if the response is a Friend Update.
+ */
+void lpn_power_stats_response(wiced_bool_t update, wiced_bool_t more_data, wiced_bool_t early_sleep);
+
+/*
+ * End of a poll cycle, the node goes to sleep
+ */
+void lpn_power_stats_sleep(void);
+
+/*
+ * Clear the statistics
+ */
+void lpn_power_stats_reset(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t lpn_power_stats_serialize(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void lpn_power_stats_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
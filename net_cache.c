@@ -0,0 +1,188 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Relay network message cache. The mesh core asks the application whether a received network
+ * PDU has been seen before, a PDU found in the cache is neither relayed nor processed again.
+ *
+ * The cache is set associative: the source address and sequence number select a bucket of
+ * NET_CACHE_WAYS entries, a lookup compares at most NET_CACHE_WAYS entries and a new PDU replaces
+ * the oldest entry of its bucket. When the cache is too small for the PDUs in flight, an entry
+ * is replaced before the last copy of the PDU arrives and the PDU is relayed again; a high
+ * eviction count compared to misses means NET_CACHE_SIZE should be increased.
+ *
+ * The prebuilt mesh core keeps its own network message cache and does not ask the application.
+ * The module is written against an assumed extension of the core API,
+ * wiced_bt_mesh_core_register_net_cache_cb, and needs a core which provides it. RELAY_PRUNE and
+ * ADAPTIVE_TX read the counters of this cache and depend on the same hook.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "net_cache.h"
+#ifdef RELAY_PRUNE
+#include "relay_prune.h"
+#endif
+
+#if defined(NET_CACHE) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+// Multiplicative hash, PDUs from one source have consecutive sequence numbers
+#define NET_CACHE_HASH(src, seq)        ((uint16_t)((((uint32_t)(src) * 40503u) ^ ((seq) * 2654435761u)) % NET_CACHE_BUCKETS))
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        src;                        // 0 if the entry is empty
+    uint32_t        seq;
+} net_cache_entry_t;
+
+typedef struct
+{
+    net_cache_entry_t   entries[NET_CACHE_WAYS];
+    uint8_t             next;                   // entry to replace
+} net_cache_bucket_t;
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static net_cache_bucket_t net_cache[NET_CACHE_BUCKETS];
+
+static uint32_t net_cache_hits      = 0;
+static uint32_t net_cache_misses    = 0;
+static uint32_t net_cache_evictions = 0;
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Register the network message cache with the mesh core
+ */
+void net_cache_init(void)
+{
+    memset(net_cache, 0, sizeof(net_cache));
+    WICED_BT_TRACE("net cache size:%d\n", NET_CACHE_SIZE);
+    wiced_bt_mesh_core_register_net_cache_cb(net_cache_check);
+}
+
+/*
+ * Check network PDU received from src with the sequence number. Returns WICED_TRUE if the PDU
+ * is in the cache, otherwise adds it and returns WICED_FALSE.
+ */
+wiced_bool_t net_cache_check(uint16_t src, uint32_t seq)
+{
+    net_cache_bucket_t *p_bucket = &net_cache[NET_CACHE_HASH(src, seq)];
+    net_cache_entry_t  *p_entry;
+    int                 i;
+
+    for (i = 0; i < NET_CACHE_WAYS; i++)
+    {
+        if ((p_bucket->entries[i].src == src) && (p_bucket->entries[i].seq == seq))
+        {
+            net_cache_hits++;
+#ifdef RELAY_PRUNE
+            relay_prune_pdu_received(WICED_TRUE);
+#endif
+            return WICED_TRUE;
+        }
+    }
+    net_cache_misses++;
+#ifdef RELAY_PRUNE
+    relay_prune_pdu_received(WICED_FALSE);
+#endif
+
+    p_entry = &p_bucket->entries[p_bucket->next];
+    if (p_entry->src != 0)
+        net_cache_evictions++;
+    p_entry->src = src;
+    p_entry->seq = seq;
+    p_bucket->next = (p_bucket->next + 1) % NET_CACHE_WAYS;
+    return WICED_FALSE;
+}
+
+/*
+ * Returns number of hits (duplicate PDUs) and misses (new PDUs) since reset
+ */
+void net_cache_get_counters(uint32_t *p_hits, uint32_t *p_misses)
+{
+    *p_hits   = net_cache_hits;
+    *p_misses = net_cache_misses;
+}
+
+/*
+ * Clear the counters
+ */
+void net_cache_reset_stats(void)
+{
+    net_cache_hits      = 0;
+    net_cache_misses    = 0;
+    net_cache_evictions = 0;
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t net_cache_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+
+    UINT16_TO_STREAM(p, NET_CACHE_SIZE);
+    UINT32_TO_STREAM(p, net_cache_hits);
+    UINT32_TO_STREAM(p, net_cache_misses);
+    UINT32_TO_STREAM(p, net_cache_evictions);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void net_cache_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[NET_CACHE_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_NET_CACHE_STATS, buffer, net_cache_serialize_stats(buffer));
+#endif
+}
+
+#endif // NET_CACHE && !LOW_POWER_NODE
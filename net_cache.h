@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Relay network message cache API definition
+ */
+
+#ifndef __NET_CACHE__H
+#define __NET_CACHE__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef NET_CACHE_SIZE
+#define NET_CACHE_SIZE                      64      // entries, multiple of NET_CACHE_WAYS
+#endif
+#define NET_CACHE_WAYS                      4       // entries of one bucket
+#define NET_CACHE_BUCKETS                   (NET_CACHE_SIZE / NET_CACHE_WAYS)
+
+#if (NET_CACHE_SIZE < NET_CACHE_WAYS) || (NET_CACHE_SIZE % NET_CACHE_WAYS) != 0
+#error NET_CACHE_SIZE must be a multiple of NET_CACHE_WAYS
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   cache size (2), hits (4), misses (4), evictions (4)
+ */
+#define NET_CACHE_STATS_LEN                 (2 + 4 * 3)
+
+/*
+ * Register the network message cache with the mesh core
+ */
+void net_cache_init(void);
+
+/*
+ * Check network PDU received from src with the sequence number. Returns WICED_TRUE if the PDU
+ * is in the cache, otherwise adds it and returns WICED_FALSE.
+ */
+wiced_bool_t net_cache_check(uint16_t src, uint32_t seq);
+
+/*
+ * Returns number of hits (duplicate PDUs) and misses (new PDUs) since reset
+ */
+void net_cache_get_counters(uint32_t *p_hits, uint32_t *p_misses);
+
+/*
+ * Clear the counters
+ */
+void net_cache_reset_stats(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t net_cache_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void net_cache_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
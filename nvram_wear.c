@@ -0,0 +1,235 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Sequence number block persistence and NVRAM wear statistics.
+ *
+ * Every Poll and publication consumes a sequence number. The mesh core does not write each
+ * sequence number to the NVRAM, it reserves a block of numbers with one write and uses them
+ * from RAM. After a reset, or a wake up from HID-OFF which is a reset too, the core continues
+ * from the end of the reserved block, so a sequence number is never reused; the unused rest
+ * of the block is skipped. A large block means few flash writes, a small block means few
+ * skipped sequence numbers on every reset.
+ *
+ * The block size is selected so that a block lasts about NVRAM_WEAR_BLOCK_PERIOD. The initial
+ * size is calculated from the poll timeout, then it is adjusted from the observed time between
+ * reservations, which covers predictive polling and publications. A low power node which
+ * enters HID-OFF on every sleep loses the block on every wake up and uses the smallest block.
+ *
+ * Writes are counted to project the number of NVRAM writes per day and the flash lifetime.
+ * With SEQ_BLOCK_SIZE=core the block reservations of the core are not seen, they are the
+ * largest writer on a low power node, so the projection is reported as unknown.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_hal_nvram.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "nvram_wear.h"
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define NVRAM_WEAR_BLOCK_MIN            32          // sequence numbers used in one wake up with retries
+#define NVRAM_WEAR_BLOCK_MAX            8192        // sequence numbers skipped after a reset
+#define NVRAM_WEAR_BLOCK_PERIOD         3600        // target time between block reservations in seconds
+#define NVRAM_WEAR_SEQ_PER_POLL         2           // Poll and retries or Friend Poll with more data
+#define NVRAM_WEAR_HID_OFF_SLEEP        1200        // poll timeout in 100 ms units above which the LPN uses HID-OFF
+
+// Platform flash parameters used for the lifetime projection
+#ifndef NVRAM_WEAR_FLASH_ENDURANCE
+#define NVRAM_WEAR_FLASH_ENDURANCE      100000      // erase cycles of a flash sector
+#endif
+#ifndef NVRAM_WEAR_VS_AREA_LEN
+#define NVRAM_WEAR_VS_AREA_LEN          8192        // size of the VS NVRAM area in bytes
+#endif
+#define NVRAM_WEAR_WRITE_LEN            32          // average bytes used in the flash by one write, record header included
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        block_size;
+    uint32_t        seq_blocks;                 // blocks reserved since reset
+    uint32_t        app_writes;                 // application NVRAM writes since reset
+    uint64_t        last_block_us;
+} nvram_wear_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+#ifdef SEQ_BLOCK_SIZE
+static void nvram_wear_seq_block_cb(uint32_t seq_limit);
+static uint16_t nvram_wear_initial_block_size(void);
+#endif
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+#if defined(SEQ_BLOCK_SIZE) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+extern wiced_bt_mesh_core_config_t mesh_config;
+#endif
+
+static nvram_wear_state_t nvram_wear = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Select the sequence number block size and register for block reservations of the mesh core
+ */
+void nvram_wear_init(wiced_bool_t is_provisioned)
+{
+#ifdef SEQ_BLOCK_SIZE
+    nvram_wear.block_size    = (SEQ_BLOCK_SIZE != 0) ? SEQ_BLOCK_SIZE : nvram_wear_initial_block_size();
+    nvram_wear.last_block_us = clock_SystemTimeMicroseconds64();
+
+    WICED_BT_TRACE("seq block size:%d\n", nvram_wear.block_size);
+    wiced_bt_mesh_core_set_seq_block_size(nvram_wear.block_size);
+    wiced_bt_mesh_core_register_seq_block_cb(nvram_wear_seq_block_cb);
+#endif
+}
+
+/*
+ * Write application data to the NVRAM and count the write
+ */
+uint16_t nvram_wear_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status)
+{
+    nvram_wear.app_writes++;
+    return wiced_hal_write_nvram(vs_id, data_length, p_data, p_status);
+}
+
+#ifdef SEQ_BLOCK_SIZE
+/*
+ * Mesh core persisted the end of a new block of sequence numbers. With the automatic size
+ * the block is doubled if it lasted less than half of the target period and halved if it
+ * lasted more than twice the period. The new size is used for the next reservation.
+ */
+static void nvram_wear_seq_block_cb(uint32_t seq_limit)
+{
+    uint64_t now_us    = clock_SystemTimeMicroseconds64();
+    uint32_t elapsed_s = (uint32_t)((now_us - nvram_wear.last_block_us) / 1000000);
+
+    nvram_wear.seq_blocks++;
+    nvram_wear.last_block_us = now_us;
+
+#if (SEQ_BLOCK_SIZE == 0)
+    // The first reservation after reset says nothing about the rate
+    if (nvram_wear.seq_blocks == 1)
+        return;
+
+    if ((elapsed_s < NVRAM_WEAR_BLOCK_PERIOD / 2) && (nvram_wear.block_size < NVRAM_WEAR_BLOCK_MAX))
+        nvram_wear.block_size *= 2;
+    else if ((elapsed_s > NVRAM_WEAR_BLOCK_PERIOD * 2) && (nvram_wear.block_size > NVRAM_WEAR_BLOCK_MIN))
+        nvram_wear.block_size /= 2;
+    else
+        return;
+
+    WICED_BT_TRACE("seq limit:%d block lasted:%d s new size:%d\n", seq_limit, elapsed_s, nvram_wear.block_size);
+    wiced_bt_mesh_core_set_seq_block_size(nvram_wear.block_size);
+#endif
+}
+
+/*
+ * Returns block size which lasts about NVRAM_WEAR_BLOCK_PERIOD at the configured poll rate
+ */
+static uint16_t nvram_wear_initial_block_size(void)
+{
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    uint32_t seq_per_period;
+    uint16_t block = NVRAM_WEAR_BLOCK_MIN;
+
+    // Every wake up from HID-OFF skips the rest of the block
+    if (mesh_config.low_power.poll_timeout >= NVRAM_WEAR_HID_OFF_SLEEP)
+        return NVRAM_WEAR_BLOCK_MIN;
+
+    seq_per_period = NVRAM_WEAR_BLOCK_PERIOD * 10 / mesh_config.low_power.poll_timeout * NVRAM_WEAR_SEQ_PER_POLL;
+    while ((block < seq_per_period) && (block < NVRAM_WEAR_BLOCK_MAX))
+        block *= 2;
+    return block;
+#else
+    // Relay and friend nodes send only their own publications and Friend Updates
+    return NVRAM_WEAR_BLOCK_MIN * 8;
+#endif
+}
+#endif
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t nvram_wear_serialize(uint8_t *p_buffer)
+{
+    uint8_t  *p = p_buffer;
+    uint32_t  uptime_s = (uint32_t)(clock_SystemTimeMicroseconds64() / 1000000);
+    uint32_t  writes_per_day = 0;
+    uint32_t  lifetime_days  = 0xffffffff;
+
+#ifdef SEQ_BLOCK_SIZE
+    if (uptime_s != 0)
+        writes_per_day = (uint32_t)((uint64_t)(nvram_wear.seq_blocks + nvram_wear.app_writes) * 86400 / uptime_s);
+
+    // Writes are spread over the whole VS area before a sector is erased again
+    if (writes_per_day != 0)
+        lifetime_days = (uint32_t)((uint64_t)NVRAM_WEAR_FLASH_ENDURANCE * (NVRAM_WEAR_VS_AREA_LEN / NVRAM_WEAR_WRITE_LEN) / writes_per_day);
+#else
+    // Sequence number blocks of the core are not counted, the projection is unknown
+    writes_per_day = 0xffffffff;
+#endif
+
+    UINT16_TO_STREAM(p, nvram_wear.block_size);
+    UINT32_TO_STREAM(p, nvram_wear.seq_blocks);
+    UINT32_TO_STREAM(p, nvram_wear.app_writes);
+    UINT32_TO_STREAM(p, uptime_s);
+    UINT32_TO_STREAM(p, writes_per_day);
+    UINT32_TO_STREAM(p, lifetime_days);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void nvram_wear_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[NVRAM_WEAR_RECORD_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_NVRAM_STATS, buffer, nvram_wear_serialize(buffer));
+#endif
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Sequence number block persistence and NVRAM wear statistics API definition
+ */
+
+#ifndef __NVRAM_WEAR__H
+#define __NVRAM_WEAR__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   sequence number block size (2, 0 with the core default), sequence number blocks persisted (4),
+ *   application NVRAM writes (4), time since reset in seconds (4), projected NVRAM writes per day (4),
+ *   projected flash lifetime in days (4)
+ */
+#define NVRAM_WEAR_RECORD_LEN               (2 + 4 * 5)
+
+/*
+ * Select the sequence number block size and register for block reservations of the mesh core
+ */
+void nvram_wear_init(wiced_bool_t is_provisioned);
+
+/*
+ * Write application data to the NVRAM and count the write
+ */
+uint16_t nvram_wear_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t nvram_wear_serialize(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void nvram_wear_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
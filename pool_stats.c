@@ -0,0 +1,234 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Buffer pool usage. The stack keeps for each buffer pool of wiced_bt_cfg the buffer size, the
+ * number of buffers, the buffers allocated now and the maximum allocated since boot. Failed
+ * allocations are not counted by the stack, so the pools are sampled: a pool with all buffers
+ * allocated at a sample is exhausted and the next allocation fails. The maximum allocated is
+ * kept by the stack since boot and cannot be cleared, so it cannot tell whether a pool was
+ * exhausted again between two samples; it is reported as it is and a maximum equal to the
+ * number of buffers only shows that the pool was exhausted at least once. The occupancy of every
+ * pool at the last exhaustion is kept, it shows which traffic filled the pool.
+ *
+ * The friend samples every POOL_STATS_INTERVAL ms. The LPN samples when the core puts it to
+ * sleep after each poll cycle and when a message is received, so that the periodic timer does
+ * not wake it up; this needs no poll cycle events from the core.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_memory.h"
+#include "wiced_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "pool_stats.h"
+
+#ifdef POOL_STATS
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define POOL_STATS_INTERVAL             200         // ms between samples of the friend
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        exhausted_at;               // buffers of the pool allocated at the last exhaustion of any pool
+    uint32_t        exhausted;                  // samples which found the pool exhausted
+} pool_stats_pool_t;
+
+typedef struct
+{
+#if !defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)
+    wiced_timer_t   timer;
+    wiced_bool_t    timer_initialized;
+#endif
+    uint32_t        samples;
+    pool_stats_pool_t pools[POOL_STATS_MAX_POOLS];
+} pool_stats_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+#if !defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)
+static void pool_stats_timer_cb(TIMER_PARAM_TYPE arg);
+#endif
+static uint8_t pool_stats_read(wiced_bt_buffer_statistics_t *p_stats);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static pool_stats_state_t pool_stats = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Start sampling
+ */
+void pool_stats_init(void)
+{
+    pool_stats_sample();
+
+#if !defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)
+    if (!pool_stats.timer_initialized)
+    {
+        wiced_init_timer(&pool_stats.timer, pool_stats_timer_cb, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+        pool_stats.timer_initialized = WICED_TRUE;
+    }
+    wiced_stop_timer(&pool_stats.timer);
+    wiced_start_timer(&pool_stats.timer, POOL_STATS_INTERVAL);
+#endif
+}
+
+#if !defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0)
+/*
+ * Periodic sample of the friend
+ */
+static void pool_stats_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    pool_stats_sample();
+}
+#endif
+
+/*
+ * Read the pool statistics of the stack. Returns number of pools.
+ */
+static uint8_t pool_stats_read(wiced_bt_buffer_statistics_t *p_stats)
+{
+    uint8_t num_pools = 0;
+
+    memset(p_stats, 0, POOL_STATS_MAX_POOLS * sizeof(wiced_bt_buffer_statistics_t));
+    wiced_bt_get_buffer_usage(p_stats, POOL_STATS_MAX_POOLS * sizeof(wiced_bt_buffer_statistics_t));
+
+    while ((num_pools < POOL_STATS_MAX_POOLS) && (p_stats[num_pools].total_count != 0))
+        num_pools++;
+    return num_pools;
+}
+
+/*
+ * Check the pools for exhaustion
+ */
+void pool_stats_sample(void)
+{
+    wiced_bt_buffer_statistics_t stats[POOL_STATS_MAX_POOLS];
+    uint8_t num_pools = pool_stats_read(stats);
+    wiced_bool_t exhausted = WICED_FALSE;
+    pool_stats_pool_t *p_pool;
+    uint8_t i;
+
+    pool_stats.samples++;
+
+    for (i = 0; i < num_pools; i++)
+    {
+        p_pool = &pool_stats.pools[i];
+
+        if (stats[i].current_allocated_count >= stats[i].total_count)
+        {
+            p_pool->exhausted++;
+            exhausted = WICED_TRUE;
+            WICED_BT_TRACE("pool %d size:%d exhausted, %d buffers\n", i, stats[i].pool_size, stats[i].total_count);
+        }
+    }
+
+    if (exhausted)
+    {
+        for (i = 0; i < num_pools; i++)
+            pool_stats.pools[i].exhausted_at = stats[i].current_allocated_count;
+    }
+}
+
+/*
+ * Clear the exhaustion counters. The maximum allocated is kept by the stack since boot.
+ */
+void pool_stats_reset(void)
+{
+    uint8_t i;
+
+    pool_stats.samples = 0;
+    for (i = 0; i < POOL_STATS_MAX_POOLS; i++)
+    {
+        pool_stats.pools[i].exhausted    = 0;
+        pool_stats.pools[i].exhausted_at = 0;
+    }
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t pool_stats_serialize_stats(uint8_t *p_buffer)
+{
+    wiced_bt_buffer_statistics_t stats[POOL_STATS_MAX_POOLS];
+    uint8_t num_pools = pool_stats_read(stats);
+    uint8_t *p = p_buffer;
+    uint8_t i;
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    UINT8_TO_STREAM(p, POOL_STATS_ROLE_LPN);
+#else
+    UINT8_TO_STREAM(p, POOL_STATS_ROLE_FRIEND);
+#endif
+    UINT8_TO_STREAM(p, num_pools);
+    UINT32_TO_STREAM(p, pool_stats.samples);
+    for (i = 0; i < num_pools; i++)
+    {
+        UINT16_TO_STREAM(p, stats[i].pool_size);
+        UINT16_TO_STREAM(p, stats[i].total_count);
+        UINT16_TO_STREAM(p, stats[i].current_allocated_count);
+        UINT16_TO_STREAM(p, stats[i].max_allocated_count);
+        UINT32_TO_STREAM(p, pool_stats.pools[i].exhausted);
+        UINT16_TO_STREAM(p, pool_stats.pools[i].exhausted_at);
+    }
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void pool_stats_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[POOL_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_POOL_STATS, buffer, pool_stats_serialize_stats(buffer));
+#endif
+}
+
+#endif // POOL_STATS
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Buffer pool usage API definition
+ */
+
+#ifndef __POOL_STATS__H
+#define __POOL_STATS__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POOL_STATS_MAX_POOLS                8
+
+#define POOL_STATS_ROLE_FRIEND              0
+#define POOL_STATS_ROLE_LPN                 1
+
+/*
+ * Serialized statistics, little endian
+ *   role (1, 0 friend, 1 LPN), number of pools (1), samples (4), then for each pool the buffer
+ *   size, number of buffers, buffers allocated now and maximum allocated since boot (2 each),
+ *   samples which found the pool exhausted (4) and buffers of the pool allocated at the last
+ *   exhaustion of any pool (2). tools/pool_sizing/pool_sizing.py reads this record.
+ */
+#define POOL_STATS_POOL_LEN                 (2 + 2 + 2 + 2 + 4 + 2)
+#define POOL_STATS_LEN                      (1 + 1 + 4 + POOL_STATS_MAX_POOLS * POOL_STATS_POOL_LEN)
+
+/*
+ * Start sampling
+ */
+void pool_stats_init(void);
+
+/*
+ * Check the pools for exhaustion
+ */
+void pool_stats_sample(void);
+
+/*
+ * Clear the exhaustion counters
+ */
+void pool_stats_reset(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t pool_stats_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void pool_stats_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Predictive poll schedule. Commands to the lights follow daily patterns, so the low power
+ * node keeps a time of day histogram of received commands. In the windows where commands
+ * are likely the node polls every PREDICTIVE_POLL_BUSY_INTERVAL, otherwise it only polls at
+ * the poll timeout. The compiled poll timeout is stretched to PREDICTIVE_POLL_POLL_TIMEOUT, a
+ * value set with Friendship Config replaces it.
+ *
+ * The histogram uses one byte per bin. When a bin saturates all bins are halved, so that the
+ * old pattern fades out. Time of day is taken from the synchronized clock, the histogram is
+ * not updated and not used while the clock is not synchronized.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_hal_nvram.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "sync_actuation.h"
+#include "predictive_poll.h"
+#include "nvram_wear.h"
+
+#if defined(PREDICTIVE_POLL) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define PREDICTIVE_POLL_BINS                48                      // 30 minutes bins
+#define PREDICTIVE_POLL_BIN_MS              ((24 * 60 * 60 * 1000) / PREDICTIVE_POLL_BINS)
+#define PREDICTIVE_POLL_BUSY_INTERVAL       2000                    // poll interval in busy windows, ms
+#define PREDICTIVE_POLL_BUSY_FACTOR         2                       // window is busy if it has this many times the average count
+#define PREDICTIVE_POLL_MIN_COUNT           3                       // and at least this many commands
+#define PREDICTIVE_POLL_SAVE_INTERVAL       (60 * 60 * 1000000ULL)  // save changed histogram at most once per hour, us
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t         bins[PREDICTIVE_POLL_BINS];     // saved in the NVRAM
+    wiced_bool_t    dirty;
+    wiced_bool_t    early_wake;                     // wake timer was shortened for the busy window
+    uint64_t        last_save_us;
+} predictive_poll_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static wiced_bool_t predictive_poll_get_bin(uint8_t *p_bin);
+static wiced_bool_t predictive_poll_is_busy(uint8_t bin);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static predictive_poll_state_t predictive_poll = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Initialize predictive poll, restore learned traffic histogram from the NVRAM
+ */
+void predictive_poll_init(wiced_bool_t is_provisioned)
+{
+    wiced_result_t result;
+
+    if (!is_provisioned)
+    {
+        // New network, forget the pattern learned in the old one
+        memset(predictive_poll.bins, 0, sizeof(predictive_poll.bins));
+        return;
+    }
+    if (wiced_hal_read_nvram(LOW_POWER_LED_NVRAM_ID_PREDICTIVE_POLL, sizeof(predictive_poll.bins), predictive_poll.bins, &result) != sizeof(predictive_poll.bins))
+    {
+        memset(predictive_poll.bins, 0, sizeof(predictive_poll.bins));
+    }
+    predictive_poll.last_save_us = clock_SystemTimeMicroseconds64();
+}
+
+/*
+ * Record arrival of a command in the time of day histogram
+ */
+void predictive_poll_record_command(void)
+{
+    uint8_t bin;
+    int     i;
+
+    if (!predictive_poll_get_bin(&bin))
+        return;
+
+    if (predictive_poll.bins[bin] == 0xff)
+    {
+        for (i = 0; i < PREDICTIVE_POLL_BINS; i++)
+            predictive_poll.bins[i] >>= 1;
+    }
+    predictive_poll.bins[bin]++;
+    predictive_poll.dirty = WICED_TRUE;
+
+    if (clock_SystemTimeMicroseconds64() - predictive_poll.last_save_us > PREDICTIVE_POLL_SAVE_INTERVAL)
+        predictive_poll_save();
+}
+
+/*
+ * Returns sleep duration to use. In a predicted busy window the sleep is shortened
+ * so that the node polls the friend more often.
+ */
+uint32_t predictive_poll_sleep_duration(uint32_t max_sleep_duration)
+{
+    uint8_t bin;
+
+    predictive_poll.early_wake = WICED_FALSE;
+
+    if ((max_sleep_duration <= PREDICTIVE_POLL_BUSY_INTERVAL) || !predictive_poll_get_bin(&bin))
+        return max_sleep_duration;
+
+    // Look at the next bin as well to start polling fast at the beginning of the busy window
+    if (!predictive_poll_is_busy(bin) && !predictive_poll_is_busy((bin + 1) % PREDICTIVE_POLL_BINS))
+        return max_sleep_duration;
+
+    predictive_poll.early_wake = WICED_TRUE;
+    return PREDICTIVE_POLL_BUSY_INTERVAL;
+}
+
+/*
+ * Called when the node wakes up from the wake timer. Sends the extra poll if the
+ * wake up was scheduled by the busy window.
+ */
+void predictive_poll_wake(void)
+{
+    if (!predictive_poll.early_wake)
+        return;
+
+    predictive_poll.early_wake = WICED_FALSE;
+
+    // Core restarts the poll timer after the poll
+    WICED_BT_TRACE("predictive poll\n");
+    wiced_bt_mesh_core_lpn_send_poll();
+}
+
+/*
+ * Save learned histogram to the NVRAM if it has been changed. Called before HID-off.
+ */
+void predictive_poll_save(void)
+{
+    wiced_result_t result;
+
+    if (!predictive_poll.dirty)
+        return;
+
+    nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_PREDICTIVE_POLL, sizeof(predictive_poll.bins), predictive_poll.bins, &result);
+    WICED_BT_TRACE("predictive poll save result:%d\n", result);
+
+    predictive_poll.dirty        = WICED_FALSE;
+    predictive_poll.last_save_us = clock_SystemTimeMicroseconds64();
+}
+
+/*
+ * Returns histogram bin of the current time of day
+ */
+static wiced_bool_t predictive_poll_get_bin(uint8_t *p_bin)
+{
+    uint64_t tai_ms;
+
+    if (!sync_actuation_get_time(&tai_ms))
+        return WICED_FALSE;
+
+    *p_bin = (uint8_t)((tai_ms % (24 * 60 * 60 * 1000)) / PREDICTIVE_POLL_BIN_MS);
+    return WICED_TRUE;
+}
+
+/*
+ * Bin is busy if it has significantly more commands than the average bin
+ */
+static wiced_bool_t predictive_poll_is_busy(uint8_t bin)
+{
+    uint32_t total = 0;
+    int      i;
+
+    for (i = 0; i < PREDICTIVE_POLL_BINS; i++)
+        total += predictive_poll.bins[i];
+
+    return (predictive_poll.bins[bin] >= PREDICTIVE_POLL_MIN_COUNT) &&
+           ((uint32_t)predictive_poll.bins[bin] * PREDICTIVE_POLL_BINS >= total * PREDICTIVE_POLL_BUSY_FACTOR);
+}
+
+#endif // PREDICTIVE_POLL && LOW_POWER_NODE
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Predictive poll schedule API definition
+ */
+
+#ifndef __PREDICTIVE_POLL__H
+#define __PREDICTIVE_POLL__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PREDICTIVE_POLL_POLL_TIMEOUT        600     // compiled poll timeout, busy windows are polled more often, 100 ms units
+
+/*
+ * Initialize predictive poll, restore learned traffic histogram from the NVRAM
+ */
+void predictive_poll_init(wiced_bool_t is_provisioned);
+
+/*
+ * Record arrival of a command in the time of day histogram
+ */
+void predictive_poll_record_command(void);
+
+/*
+ * Returns sleep duration to use. In a predicted busy window the sleep is shortened
+ * so that the node polls the friend more often.
+ */
+uint32_t predictive_poll_sleep_duration(uint32_t max_sleep_duration);
+
+/*
+ * Called when the node wakes up from the wake timer. Sends the extra poll if the
+ * wake up was scheduled by the busy window.
+ */
+void predictive_poll_wake(void);
+
+/*
+ * Save learned histogram to the NVRAM if it has been changed. Called before HID-off.
+ */
+void predictive_poll_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * On-demand GATT proxy advertising. Every lighting node supports the GATT Proxy feature but
+ * phones rarely connect, and proxy advertisements from hundreds of nodes take a large share of
+ * the advertising channels. The node keeps proxy advertising off and enables it for
+ * PROXY_ON_DEMAND_WINDOW seconds when a Solicitation PDU is received from a phone or when the
+ * host asks over WICED HCI. While a proxy client is connected advertising is not needed; after
+ * the client disconnects the window is started again so that the phone can reconnect.
+ *
+ * The button stays with mesh_app_lib, which registers the only callback of the button for its
+ * factory reset. An application which handles the button itself can start a window with
+ * PROXY_ON_DEMAND_TRIGGER_LOCAL. Until the node is provisioned mesh_app_lib controls the
+ * advertising, triggers and connections of PB-GATT provisioning are ignored. When the node has
+ * just been provisioned, and when it boots provisioned, a first window is started, so that the
+ * phone or MeshClient which provisioned it can connect through the proxy to configure it
+ * without sending a Solicitation PDU.
+ *
+ * The prebuilt mesh core neither passes Solicitation PDUs to the application nor lets it turn
+ * proxy advertising on and off. The module is written against an assumed extension of the core
+ * API, wiced_bt_mesh_core_register_proxy_solicitation_cb and wiced_bt_mesh_core_proxy_adv_enable,
+ * and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "proxy_on_demand.h"
+
+#if defined(PROXY_ON_DEMAND) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    wiced_timer_t   timer;
+    wiced_bool_t    timer_initialized;
+    wiced_bool_t    active;                     // node is provisioned, the module controls proxy advertising
+    wiced_bool_t    advertising;
+    wiced_bool_t    connected;
+    uint64_t        start_us;                   // time advertising was enabled
+    uint32_t        windows[PROXY_ON_DEMAND_TRIGGERS];  // windows started per trigger
+    uint32_t        connections;
+    uint32_t        adv_seconds;                // total time with proxy advertising enabled
+} proxy_on_demand_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static void proxy_on_demand_timer_cb(TIMER_PARAM_TYPE arg);
+static void proxy_on_demand_solicitation_cb(uint16_t src);
+static void proxy_on_demand_stop(void);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static proxy_on_demand_state_t proxy_on_demand = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Initialize the window timer. On a provisioned node register the triggers and start the
+ * first window, proxy advertising is turned off when it ends.
+ */
+void proxy_on_demand_init(wiced_bool_t is_provisioned)
+{
+    if (!proxy_on_demand.timer_initialized)
+    {
+        wiced_init_timer(&proxy_on_demand.timer, proxy_on_demand_timer_cb, 0, WICED_SECONDS_TIMER);
+        proxy_on_demand.timer_initialized = WICED_TRUE;
+    }
+    wiced_stop_timer(&proxy_on_demand.timer);
+    proxy_on_demand.active = is_provisioned;
+    if (!is_provisioned)
+        return;
+
+    // The core advertises the proxy service after provisioning, the first window keeps it on
+    proxy_on_demand.advertising = WICED_TRUE;
+    proxy_on_demand.start_us    = clock_SystemTimeMicroseconds64();
+    proxy_on_demand.connected   = WICED_FALSE;
+    proxy_on_demand_start(PROXY_ON_DEMAND_TRIGGER_PROVISIONED, 0);
+
+    wiced_bt_mesh_core_register_proxy_solicitation_cb(proxy_on_demand_solicitation_cb);
+}
+
+/*
+ * Enable proxy advertising for window seconds, 0 for PROXY_ON_DEMAND_WINDOW. A running window
+ * is extended.
+ */
+void proxy_on_demand_start(uint8_t trigger, uint16_t window)
+{
+    if (!proxy_on_demand.active)
+        return;
+
+    if (trigger < PROXY_ON_DEMAND_TRIGGERS)
+        proxy_on_demand.windows[trigger]++;
+
+    if (window == 0)
+        window = PROXY_ON_DEMAND_WINDOW;
+
+    WICED_BT_TRACE("proxy adv on trigger:%d window:%d connected:%d\n", trigger, window, proxy_on_demand.connected);
+
+    // Connected client does not need advertising, the window starts on disconnection
+    if (proxy_on_demand.connected)
+        return;
+
+    if (!proxy_on_demand.advertising)
+    {
+        proxy_on_demand.advertising = WICED_TRUE;
+        proxy_on_demand.start_us    = clock_SystemTimeMicroseconds64();
+        wiced_bt_mesh_core_proxy_adv_enable(WICED_TRUE);
+    }
+    wiced_stop_timer(&proxy_on_demand.timer);
+    wiced_start_timer(&proxy_on_demand.timer, window);
+}
+
+/*
+ * GATT connection status, the proxy client connected or disconnected
+ */
+void proxy_on_demand_conn_status(wiced_bt_gatt_connection_status_t *p_status)
+{
+    // PB-GATT provisioning connection
+    if (!proxy_on_demand.active)
+        return;
+
+    proxy_on_demand.connected = p_status->connected;
+    if (p_status->connected)
+    {
+        proxy_on_demand.connections++;
+        wiced_stop_timer(&proxy_on_demand.timer);
+        proxy_on_demand_stop();
+    }
+    else
+    {
+        proxy_on_demand_start(PROXY_ON_DEMAND_TRIGGER_DISCONNECT, 0);
+    }
+}
+
+/*
+ * Solicitation PDU received from a proxy client
+ */
+static void proxy_on_demand_solicitation_cb(uint16_t src)
+{
+    proxy_on_demand_start(PROXY_ON_DEMAND_TRIGGER_SOLICITATION, 0);
+}
+
+/*
+ * Window ended without a connection
+ */
+static void proxy_on_demand_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    proxy_on_demand_stop();
+}
+
+/*
+ * Disable proxy advertising and account the time it was enabled
+ */
+static void proxy_on_demand_stop(void)
+{
+    if (!proxy_on_demand.advertising)
+        return;
+
+    proxy_on_demand.advertising = WICED_FALSE;
+    proxy_on_demand.adv_seconds += (uint32_t)((clock_SystemTimeMicroseconds64() - proxy_on_demand.start_us) / 1000000);
+    wiced_bt_mesh_core_proxy_adv_enable(WICED_FALSE);
+    WICED_BT_TRACE("proxy adv off\n");
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t proxy_on_demand_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t  *p = p_buffer;
+    uint32_t adv_seconds = proxy_on_demand.adv_seconds;
+    int      i;
+
+    if (proxy_on_demand.advertising)
+        adv_seconds += (uint32_t)((clock_SystemTimeMicroseconds64() - proxy_on_demand.start_us) / 1000000);
+
+    UINT8_TO_STREAM(p, proxy_on_demand.advertising);
+    UINT8_TO_STREAM(p, proxy_on_demand.connected);
+    for (i = 0; i < PROXY_ON_DEMAND_TRIGGERS; i++)
+        UINT32_TO_STREAM(p, proxy_on_demand.windows[i]);
+    UINT32_TO_STREAM(p, proxy_on_demand.connections);
+    UINT32_TO_STREAM(p, adv_seconds);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void proxy_on_demand_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[PROXY_ON_DEMAND_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_PROXY_STATS, buffer, proxy_on_demand_serialize_stats(buffer));
+#endif
+}
+
+#endif // PROXY_ON_DEMAND && !LOW_POWER_NODE
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * On-demand GATT proxy advertising API definition
+ */
+
+#ifndef __PROXY_ON_DEMAND__H
+#define __PROXY_ON_DEMAND__H
+
+#include "wiced_bt_gatt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Triggers which start the proxy advertising window
+ */
+#define PROXY_ON_DEMAND_TRIGGER_SOLICITATION    0       // Solicitation PDU received
+#define PROXY_ON_DEMAND_TRIGGER_LOCAL           1       // application button processing
+#define PROXY_ON_DEMAND_TRIGGER_HOST            2       // WICED HCI command
+#define PROXY_ON_DEMAND_TRIGGER_DISCONNECT      3       // proxy client disconnected
+#define PROXY_ON_DEMAND_TRIGGER_PROVISIONED     4       // node booted provisioned or was just provisioned
+#define PROXY_ON_DEMAND_TRIGGERS                5
+
+/*
+ * Serialized statistics, little endian
+ *   advertising (1), client connected (1), windows started per trigger (4 each, in the order
+ *   of the triggers), connections (4), seconds with proxy advertising enabled (4)
+ */
+#define PROXY_ON_DEMAND_STATS_LEN               (1 + 1 + 4 * PROXY_ON_DEMAND_TRIGGERS + 4 + 4)
+
+/*
+ * Initialize the window timer. On a provisioned node register the triggers and start the
+ * first window, proxy advertising is turned off when it ends.
+ */
+void proxy_on_demand_init(wiced_bool_t is_provisioned);
+
+/*
+ * Enable proxy advertising for window seconds, 0 for PROXY_ON_DEMAND_WINDOW. A running window
+ * is extended.
+ */
+void proxy_on_demand_start(uint8_t trigger, uint16_t window);
+
+/*
+ * GATT connection status, the proxy client connected or disconnected
+ */
+void proxy_on_demand_conn_status(wiced_bt_gatt_connection_status_t *p_status);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t proxy_on_demand_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void proxy_on_demand_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
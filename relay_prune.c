@@ -0,0 +1,227 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Density aware relay pruning. In a dense room every lighting node relays every message and
+ * the copies saturate the advertising channels. A node estimates how many of its neighbours
+ * relay from the duplicate copies found in the network message cache: each relaying neighbour
+ * sends relay retransmit count + 1 copies of a PDU, so duplicates per new PDU divided by the
+ * copies is the number of neighbours which relayed it. The neighbours are assumed to use the
+ * relay retransmit count of the node, which the provisioner usually sets on all relays. With
+ * more than RELAY_PRUNE_COVERAGE relaying neighbours the node relays only with probability
+ * RELAY_PRUNE_COVERAGE / neighbours, so that RELAY_PRUNE_COVERAGE of them relay on average.
+ *
+ * Minimum coverage is kept because the probability never goes below RELAY_PRUNE_MIN_PROBABILITY,
+ * the node relays everything until it has seen RELAY_PRUNE_MIN_SAMPLES PDUs, and a node at the
+ * edge of the network, which hears few duplicates, keeps relaying everything. In an interval
+ * with too few PDUs for an estimate the old estimate decays, so that a node whose neighbours
+ * went quiet or away returns to relaying everything.
+ *
+ * The prebuilt mesh core does not let the application decide about relaying or read the relay
+ * retransmit count. The module is written against an assumed extension of the core API,
+ * wiced_bt_mesh_core_register_relay_cb and wiced_bt_mesh_core_get_relay_retransmit_count, and
+ * on the network message cache hook of net_cache.c.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "wiced_hal_rand.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "relay_prune.h"
+
+#if defined(RELAY_PRUNE) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define RELAY_PRUNE_INTERVAL            30          // seconds between density estimates
+#define RELAY_PRUNE_MIN_SAMPLES         20          // new PDUs in the interval needed for an estimate
+#define RELAY_PRUNE_COVERAGE            4           // relaying neighbours expected to cover the area
+#define RELAY_PRUNE_MIN_PROBABILITY     64          // 1/256 units, 25%
+#define RELAY_PRUNE_ALWAYS              256         // probability of a node which relays every PDU
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    wiced_timer_t   timer;
+    wiced_bool_t    timer_initialized;
+    uint32_t        new_pdus;                   // PDUs in the current interval
+    uint32_t        duplicates;
+    uint16_t        neighbours;                 // estimated relaying neighbours, 1/16 units, 0 if not known
+    uint16_t        probability;                // 1/256 units
+    uint32_t        relayed;
+    uint32_t        pruned;
+} relay_prune_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static void relay_prune_timer_cb(TIMER_PARAM_TYPE arg);
+static void relay_prune_update_probability(void);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static relay_prune_state_t relay_prune = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Start the density estimation and register the relay decision with the mesh core
+ */
+void relay_prune_init(void)
+{
+    relay_prune.probability = RELAY_PRUNE_ALWAYS;
+
+    if (!relay_prune.timer_initialized)
+    {
+        wiced_init_timer(&relay_prune.timer, relay_prune_timer_cb, 0, WICED_SECONDS_PERIODIC_TIMER);
+        relay_prune.timer_initialized = WICED_TRUE;
+    }
+    wiced_stop_timer(&relay_prune.timer);
+    wiced_start_timer(&relay_prune.timer, RELAY_PRUNE_INTERVAL);
+
+    wiced_bt_mesh_core_register_relay_cb(relay_prune_should_relay);
+}
+
+/*
+ * Network PDU received, duplicate is set if the PDU was found in the network message cache
+ */
+void relay_prune_pdu_received(wiced_bool_t duplicate)
+{
+    if (duplicate)
+        relay_prune.duplicates++;
+    else
+        relay_prune.new_pdus++;
+}
+
+/*
+ * Returns WICED_TRUE if the node should relay the network PDU
+ */
+wiced_bool_t relay_prune_should_relay(uint16_t src, uint8_t ttl)
+{
+    if ((relay_prune.probability >= RELAY_PRUNE_ALWAYS) || ((wiced_hal_rand_gen_num() & 0xff) < relay_prune.probability))
+    {
+        relay_prune.relayed++;
+        return WICED_TRUE;
+    }
+    relay_prune.pruned++;
+    return WICED_FALSE;
+}
+
+/*
+ * Update the density estimate and the relay probability at the end of the interval
+ */
+static void relay_prune_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    uint32_t neighbours;
+    uint32_t copies;
+
+    if (relay_prune.new_pdus < RELAY_PRUNE_MIN_SAMPLES)
+    {
+        // Too few PDUs for an estimate, the samples are kept for the next interval
+        if (relay_prune.neighbours != 0)
+        {
+            relay_prune.neighbours = (uint16_t)(3 * relay_prune.neighbours / 4);
+            relay_prune_update_probability();
+        }
+        return;
+    }
+
+    // Copies from the neighbours which relayed, the node's own relay is not received. The
+    // relay retransmit count is read every time, the provisioner can change it.
+    copies     = wiced_bt_mesh_core_get_relay_retransmit_count() + 1;
+    neighbours = relay_prune.duplicates * 16 / (relay_prune.new_pdus * copies);
+    relay_prune.new_pdus   = 0;
+    relay_prune.duplicates = 0;
+
+    // Pruning nodes relay less, which lowers the estimate of their neighbours. The relayed
+    // share of the neighbours is scaled back to the full neighbourhood.
+    neighbours = neighbours * RELAY_PRUNE_ALWAYS / relay_prune.probability;
+
+    relay_prune.neighbours = (relay_prune.neighbours == 0) ? (uint16_t)neighbours : (uint16_t)((3 * relay_prune.neighbours + neighbours) / 4);
+    relay_prune_update_probability();
+}
+
+/*
+ * Relay probability which leaves RELAY_PRUNE_COVERAGE of the estimated neighbours relaying
+ */
+static void relay_prune_update_probability(void)
+{
+    if (relay_prune.neighbours <= RELAY_PRUNE_COVERAGE * 16)
+        relay_prune.probability = RELAY_PRUNE_ALWAYS;
+    else
+        relay_prune.probability = (uint16_t)(RELAY_PRUNE_COVERAGE * 16 * RELAY_PRUNE_ALWAYS / relay_prune.neighbours);
+
+    if (relay_prune.probability < RELAY_PRUNE_MIN_PROBABILITY)
+        relay_prune.probability = RELAY_PRUNE_MIN_PROBABILITY;
+
+    WICED_BT_TRACE("relay prune neighbours:%d/16 probability:%d/256\n", relay_prune.neighbours, relay_prune.probability);
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t relay_prune_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+
+    UINT16_TO_STREAM(p, relay_prune.neighbours);
+    UINT16_TO_STREAM(p, relay_prune.probability);
+    UINT32_TO_STREAM(p, relay_prune.relayed);
+    UINT32_TO_STREAM(p, relay_prune.pruned);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void relay_prune_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[RELAY_PRUNE_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_RELAY_PRUNE_STATS, buffer, relay_prune_serialize_stats(buffer));
+#endif
+}
+
+#endif // RELAY_PRUNE && !LOW_POWER_NODE
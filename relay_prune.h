@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Density aware relay pruning API definition
+ */
+
+#ifndef __RELAY_PRUNE__H
+#define __RELAY_PRUNE__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   estimated relaying neighbours in 1/16 units (2), relay probability in 1/256 units (2),
+ *   PDUs relayed (4), PDUs not relayed because of pruning (4)
+ */
+#define RELAY_PRUNE_STATS_LEN               (2 + 2 + 4 + 4)
+
+/*
+ * Start the density estimation and register the relay decision with the mesh core
+ */
+void relay_prune_init(void);
+
+/*
+ * Network PDU received, duplicate is set if the PDU was found in the network message cache
+ */
+void relay_prune_pdu_received(wiced_bool_t duplicate);
+
+/*
+ * Returns WICED_TRUE if the node should relay the network PDU
+ */
+wiced_bool_t relay_prune_should_relay(uint16_t src, uint8_t ttl);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t relay_prune_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void relay_prune_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,442 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Hashed replay protection list.
+ *
+ * The mesh core asks the application to check the sequence number of every message received
+ * from a source. The list keeps the last sequence number and IV index of each source in an open
+ * addressing hash table with linear probing, so that a check costs one or two probes instead of
+ * a scan of all sources. An entry takes 8 bytes.
+ *
+ * The table is bounded to REPLAY_LIST_MAX_SOURCES. When it is full a new source replaces an
+ * entry which can not be used for a replay any more (IV index older than the previous one).
+ * If there is no such entry the message of the new source is discarded, as required by the
+ * specification. Entries of the current IV index are never removed, however long the source
+ * has been silent, otherwise its earlier messages could be replayed.
+ *
+ * The table is persisted in NVRAM records of REPLAY_LIST_RECORD_ENTRIES slots. Updates mark the
+ * record dirty and the dirty records are written together after REPLAY_LIST_FLUSH_UPDATES
+ * updates or REPLAY_LIST_FLUSH_INTERVAL, whichever comes first. Messages accepted after the
+ * last flush can be replayed once after a power loss; REPLAY_LIST_FLUSH_INTERVAL bounds that
+ * window. The records are not written on every accepted message: a relay or friend receives
+ * several messages per second and a write per message would wear the flash shared with the
+ * rest of the NVRAM within months. The low power node writes the dirty records before HID-off,
+ * so only a loss of power, not its own sleep, opens the window, and only for messages accepted
+ * in the last REPLAY_LIST_FLUSH_INTERVAL seconds.
+ *
+ * The prebuilt mesh core keeps its own replay protection list and does not ask the application.
+ * The module is written against an assumed extension of the core API,
+ * wiced_bt_mesh_core_register_replay_protection_cb, and needs a core which provides it.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "wiced_hal_nvram.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "nvram_wear.h"
+#include "replay_list.h"
+
+#ifdef REPLAY_LIST
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define REPLAY_LIST_FLUSH_UPDATES       1024        // updates which trigger write of the dirty records
+#define REPLAY_LIST_FLUSH_INTERVAL      60          // seconds from the first update to the write of the dirty records
+
+#define REPLAY_LIST_SEQ_MASK            0x00ffffff
+#define REPLAY_LIST_IVI_SHIFT           24          // low byte of the IV index is kept above the sequence number
+
+// Multiplicative hash, provisioners assign consecutive addresses which must not form one cluster
+#define REPLAY_LIST_HASH(src)           ((uint16_t)(((uint32_t)(uint16_t)((src) * 40503u) * REPLAY_LIST_SIZE) >> 16))
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        src;                        // 0 if slot is empty
+    uint16_t        reserved;                   // keeps the 8 byte NVRAM record layout
+    uint32_t        seq_ivi;                    // sequence number and low byte of the IV index
+} replay_list_entry_t;
+
+typedef struct
+{
+    uint16_t        sources;
+    uint8_t         current_ivi;                // low byte of the highest IV index received
+    uint32_t        dirty;                      // bit mask of records to write
+    uint16_t        updates;                    // updates since the last flush
+    wiced_bool_t    timer_initialized;
+    wiced_bool_t    timer_running;
+    wiced_timer_t   flush_timer;
+
+    uint32_t        checks;
+    uint32_t        replays;
+    uint32_t        probes;
+    uint16_t        max_probes;
+    uint32_t        check_us;
+    uint16_t        max_check_us;
+    uint32_t        evictions;
+    uint32_t        full_rejects;
+    uint32_t        records_written;
+} replay_list_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static int replay_list_find(uint16_t src, uint16_t *p_probes);
+static int replay_list_insert(uint16_t src, uint16_t *p_probes);
+static void replay_list_remove(int slot);
+static int replay_list_evict(void);
+static void replay_list_update(int slot, uint32_t seq, uint8_t ivi);
+static void replay_list_flush_timer_cb(TIMER_PARAM_TYPE arg);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static replay_list_entry_t replay_list[REPLAY_LIST_SIZE];
+static replay_list_state_t replay_list_state = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Restore the replay protection list from the NVRAM and register it with the mesh core
+ */
+void replay_list_init(wiced_bool_t is_provisioned)
+{
+    replay_list_entry_t record[REPLAY_LIST_RECORD_ENTRIES];
+    wiced_result_t      result;
+    uint16_t            probes;
+    uint8_t             ivi;
+    int                 i, j, slot;
+
+    if (!replay_list_state.timer_initialized)
+    {
+        wiced_init_timer(&replay_list_state.flush_timer, replay_list_flush_timer_cb, 0, WICED_SECONDS_TIMER);
+        replay_list_state.timer_initialized = WICED_TRUE;
+    }
+    if (replay_list_state.timer_running)
+    {
+        wiced_stop_timer(&replay_list_state.flush_timer);
+        replay_list_state.timer_running = WICED_FALSE;
+    }
+
+    memset(replay_list, 0, sizeof(replay_list));
+    replay_list_state.sources     = 0;
+    replay_list_state.dirty       = 0;
+    replay_list_state.current_ivi = 0;
+
+    for (i = 0; i < REPLAY_LIST_NVRAM_RECORDS; i++)
+    {
+        // Node was reset, sources of the old network must not block the new one
+        if (!is_provisioned)
+        {
+            wiced_hal_delete_nvram(LOW_POWER_LED_NVRAM_ID_REPLAY_LIST + i, &result);
+            continue;
+        }
+        if (wiced_hal_read_nvram(LOW_POWER_LED_NVRAM_ID_REPLAY_LIST + i, sizeof(record), (uint8_t *)record, &result) != sizeof(record))
+            continue;
+
+        // Written with a larger REPLAY_LIST_SIZE, entries move to the records in use
+        if (i >= REPLAY_LIST_SIZE / REPLAY_LIST_RECORD_ENTRIES)
+            wiced_hal_delete_nvram(LOW_POWER_LED_NVRAM_ID_REPLAY_LIST + i, &result);
+
+        // Records are reinserted, so the list survives change of REPLAY_LIST_SIZE
+        for (j = 0; j < REPLAY_LIST_RECORD_ENTRIES; j++)
+        {
+            if ((record[j].src == 0) || (replay_list_state.sources >= REPLAY_LIST_MAX_SOURCES))
+                continue;
+            if ((slot = replay_list_insert(record[j].src, &probes)) < 0)
+                continue;
+            replay_list[slot].seq_ivi = record[j].seq_ivi;
+            if (slot != i * REPLAY_LIST_RECORD_ENTRIES + j)
+                replay_list_state.dirty |= ((uint32_t)1 << (slot / REPLAY_LIST_RECORD_ENTRIES));
+            // The highest IV index of the entries, compared with wrap around
+            ivi = (uint8_t)(record[j].seq_ivi >> REPLAY_LIST_IVI_SHIFT);
+            if ((replay_list_state.sources == 1) || ((uint8_t)(ivi - replay_list_state.current_ivi) < 0x80))
+                replay_list_state.current_ivi = ivi;
+        }
+    }
+    WICED_BT_TRACE("replay list sources:%d\n", replay_list_state.sources);
+
+    wiced_bt_mesh_core_register_replay_protection_cb(replay_list_check);
+}
+
+/*
+ * Check a message from src with the sequence number and IV index. Returns WICED_TRUE and
+ * updates the list if the message is not a replay.
+ */
+wiced_bool_t replay_list_check(uint16_t src, uint32_t seq, uint32_t iv_index)
+{
+    uint64_t     start_us = clock_SystemTimeMicroseconds64();
+    uint8_t      ivi      = (uint8_t)iv_index;
+    uint32_t     stored_seq;
+    uint8_t      stored_ivi;
+    uint16_t     probes = 0;
+    uint16_t     check_us;
+    wiced_bool_t accept = WICED_TRUE;
+    int          slot;
+
+    replay_list_state.checks++;
+
+    if ((slot = replay_list_find(src, &probes)) >= 0)
+    {
+        stored_seq = replay_list[slot].seq_ivi & REPLAY_LIST_SEQ_MASK;
+        stored_ivi = (uint8_t)(replay_list[slot].seq_ivi >> REPLAY_LIST_IVI_SHIFT);
+
+        // IV index only increases, the low byte is compared with wrap around
+        if ((ivi == stored_ivi) ? (seq <= stored_seq) : ((uint8_t)(ivi - stored_ivi) >= 0x80))
+        {
+            replay_list_state.replays++;
+            accept = WICED_FALSE;
+        }
+    }
+    else
+    {
+        if ((replay_list_state.sources >= REPLAY_LIST_MAX_SOURCES) && (replay_list_evict() < 0))
+        {
+            replay_list_state.full_rejects++;
+            accept = WICED_FALSE;
+        }
+        else
+        {
+            slot = replay_list_insert(src, &probes);
+        }
+    }
+
+    if (accept)
+    {
+        if ((uint8_t)(ivi - replay_list_state.current_ivi) < 0x80)
+            replay_list_state.current_ivi = ivi;
+        replay_list_update(slot, seq, ivi);
+    }
+
+    replay_list_state.probes += probes;
+    if (probes > replay_list_state.max_probes)
+        replay_list_state.max_probes = probes;
+
+    check_us = (uint16_t)(clock_SystemTimeMicroseconds64() - start_us);
+    replay_list_state.check_us += check_us;
+    if (check_us > replay_list_state.max_check_us)
+        replay_list_state.max_check_us = check_us;
+
+    return accept;
+}
+
+/*
+ * Write modified records to the NVRAM. Called before HID-off.
+ */
+void replay_list_flush(void)
+{
+    wiced_result_t result;
+    int            i;
+
+    if (replay_list_state.timer_running)
+    {
+        wiced_stop_timer(&replay_list_state.flush_timer);
+        replay_list_state.timer_running = WICED_FALSE;
+    }
+    for (i = 0; i < REPLAY_LIST_SIZE / REPLAY_LIST_RECORD_ENTRIES; i++)
+    {
+        if ((replay_list_state.dirty & ((uint32_t)1 << i)) == 0)
+            continue;
+        nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_REPLAY_LIST + i, REPLAY_LIST_RECORD_ENTRIES * sizeof(replay_list_entry_t),
+                (uint8_t *)&replay_list[i * REPLAY_LIST_RECORD_ENTRIES], &result);
+        replay_list_state.records_written++;
+    }
+    replay_list_state.dirty   = 0;
+    replay_list_state.updates = 0;
+}
+
+/*
+ * Returns slot of the source, or -1 if the source is not in the list
+ */
+static int replay_list_find(uint16_t src, uint16_t *p_probes)
+{
+    uint16_t slot = REPLAY_LIST_HASH(src);
+
+    while (replay_list[slot].src != 0)
+    {
+        (*p_probes)++;
+        if (replay_list[slot].src == src)
+            return slot;
+        slot = (slot + 1) & (REPLAY_LIST_SIZE - 1);
+    }
+    (*p_probes)++;
+    return -1;
+}
+
+/*
+ * Add the source in the first empty slot of its probe sequence. Returns the slot.
+ */
+static int replay_list_insert(uint16_t src, uint16_t *p_probes)
+{
+    uint16_t slot = REPLAY_LIST_HASH(src);
+
+    while (replay_list[slot].src != 0)
+    {
+        (*p_probes)++;
+        slot = (slot + 1) & (REPLAY_LIST_SIZE - 1);
+    }
+    (*p_probes)++;
+
+    replay_list[slot].src      = src;
+    replay_list[slot].seq_ivi  = 0;
+    replay_list[slot].reserved = 0;
+    replay_list_state.sources++;
+    return slot;
+}
+
+/*
+ * Remove the entry and move following entries of the cluster back, so that lookups do not need tombstones
+ */
+static void replay_list_remove(int slot)
+{
+    uint16_t hole = (uint16_t)slot;
+    uint16_t next = (hole + 1) & (REPLAY_LIST_SIZE - 1);
+    uint16_t home;
+
+    replay_list_state.dirty |= ((uint32_t)1 << (hole / REPLAY_LIST_RECORD_ENTRIES));
+
+    while (replay_list[next].src != 0)
+    {
+        home = REPLAY_LIST_HASH(replay_list[next].src);
+
+        // Entry can fill the hole if its home slot is not between the hole and the entry
+        if (((next - home) & (REPLAY_LIST_SIZE - 1)) >= ((next - hole) & (REPLAY_LIST_SIZE - 1)))
+        {
+            replay_list[hole] = replay_list[next];
+            replay_list_state.dirty |= ((uint32_t)1 << (next / REPLAY_LIST_RECORD_ENTRIES));
+            hole = next;
+        }
+        next = (next + 1) & (REPLAY_LIST_SIZE - 1);
+    }
+    memset(&replay_list[hole], 0, sizeof(replay_list_entry_t));
+    replay_list_state.dirty |= ((uint32_t)1 << (hole / REPLAY_LIST_RECORD_ENTRIES));
+    replay_list_state.sources--;
+}
+
+/*
+ * Remove an entry which can not be used for a replay, its IV index is older than the previous one.
+ * Returns the freed slot, or -1 if no entry can be removed.
+ */
+static int replay_list_evict(void)
+{
+    uint8_t  ivi;
+    int      i;
+
+    for (i = 0; i < REPLAY_LIST_SIZE; i++)
+    {
+        if (replay_list[i].src == 0)
+            continue;
+
+        // Messages with IV index older than current - 1 are discarded by the network layer
+        ivi = (uint8_t)(replay_list[i].seq_ivi >> REPLAY_LIST_IVI_SHIFT);
+        if ((uint8_t)(replay_list_state.current_ivi - ivi) >= 2)
+        {
+            WICED_BT_TRACE("replay list evict src:%04x\n", replay_list[i].src);
+            replay_list_remove(i);
+            replay_list_state.evictions++;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Store new sequence number of the entry and schedule the write of its record
+ */
+static void replay_list_update(int slot, uint32_t seq, uint8_t ivi)
+{
+    replay_list[slot].seq_ivi = (seq & REPLAY_LIST_SEQ_MASK) | ((uint32_t)ivi << REPLAY_LIST_IVI_SHIFT);
+    replay_list_state.dirty  |= ((uint32_t)1 << (slot / REPLAY_LIST_RECORD_ENTRIES));
+
+    if (++replay_list_state.updates >= REPLAY_LIST_FLUSH_UPDATES)
+    {
+        replay_list_flush();
+    }
+    else if (!replay_list_state.timer_running)
+    {
+        wiced_start_timer(&replay_list_state.flush_timer, REPLAY_LIST_FLUSH_INTERVAL);
+        replay_list_state.timer_running = WICED_TRUE;
+    }
+}
+
+static void replay_list_flush_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    replay_list_state.timer_running = WICED_FALSE;
+    replay_list_flush();
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t replay_list_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+
+    UINT16_TO_STREAM(p, replay_list_state.sources);
+    UINT32_TO_STREAM(p, replay_list_state.checks);
+    UINT32_TO_STREAM(p, replay_list_state.replays);
+    UINT32_TO_STREAM(p, replay_list_state.probes);
+    UINT16_TO_STREAM(p, replay_list_state.max_probes);
+    UINT32_TO_STREAM(p, replay_list_state.check_us);
+    UINT16_TO_STREAM(p, replay_list_state.max_check_us);
+    UINT32_TO_STREAM(p, replay_list_state.evictions);
+    UINT32_TO_STREAM(p, replay_list_state.full_rejects);
+    UINT32_TO_STREAM(p, replay_list_state.records_written);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void replay_list_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[REPLAY_LIST_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_REPLAY_LIST_STATS, buffer, replay_list_serialize_stats(buffer));
+#endif
+}
+
+#endif // REPLAY_LIST
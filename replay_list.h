@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Hashed replay protection list API definition
+ */
+
+#ifndef __REPLAY_LIST__H
+#define __REPLAY_LIST__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef REPLAY_LIST_SIZE
+#define REPLAY_LIST_SIZE                    256     // hash table slots, power of 2
+#endif
+#define REPLAY_LIST_MAX_SOURCES             (REPLAY_LIST_SIZE * 3 / 4)  // table is never filled above 75%
+#define REPLAY_LIST_RECORD_ENTRIES          32      // entries persisted in one NVRAM record
+#define REPLAY_LIST_NVRAM_RECORDS           32      // NVRAM IDs reserved in low_power_led.h
+
+#if (REPLAY_LIST_SIZE & (REPLAY_LIST_SIZE - 1)) != 0
+#error REPLAY_LIST_SIZE must be a power of 2
+#endif
+#if (REPLAY_LIST_SIZE > REPLAY_LIST_RECORD_ENTRIES * REPLAY_LIST_NVRAM_RECORDS)
+#error REPLAY_LIST_SIZE does not fit in the reserved NVRAM records
+#endif
+
+/*
+ * Serialized statistics, little endian
+ *   sources (2), checks (4), replays rejected (4), probes (4), max probes (2), check time sum us (4),
+ *   max check time us (2), sources of an old IV index evicted (4), new sources rejected because the list is full (4),
+ *   NVRAM records written (4)
+ */
+#define REPLAY_LIST_STATS_LEN               (2 + 4 + 4 + 4 + 2 + 4 + 2 + 4 + 4 + 4)
+
+/*
+ * Restore the replay protection list from the NVRAM and register it with the mesh core
+ */
+void replay_list_init(wiced_bool_t is_provisioned);
+
+/*
+ * Check a message from src with the sequence number and IV index. Returns WICED_TRUE and
+ * updates the list if the message is not a replay.
+ */
+wiced_bool_t replay_list_check(uint16_t src, uint32_t seq, uint32_t iv_index);
+
+/*
+ * Write modified records to the NVRAM. Called before HID-off.
+ */
+void replay_list_flush(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t replay_list_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void replay_list_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Stack high-water marks of the application callbacks. Instrumentation build only.
+ *
+ * The sleep poll, the wake up timer, the model message handler, the LPN event and the WICED HCI
+ * command callbacks run in system threads with small stacks. The first time a callback runs in
+ * a thread, the free part of the thread stack below the current stack pointer is painted. When
+ * a callback returns, the stack is scanned from its start for the first word which is not paint,
+ * which gives the deepest point reached since the last scan. The used part is then painted
+ * again, so that every callback is charged only with its own depth. The same scan when a
+ * callback is entered charges the depth reached by the system between callbacks to the thread.
+ *
+ * Painting below the stack pointer is safe because interrupt handlers run on the main stack,
+ * not on the thread stacks.
+ *
+ */
+
+#include "wiced_bt_trace.h"
+#include "tx_api.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "stack_stats.h"
+
+#ifdef STACK_STATS
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define STACK_STATS_PAINT               0xEFEFEFEF
+#define STACK_STATS_MARGIN              64          // bytes below the stack pointer not painted, used by the scan itself
+#define STACK_STATS_NO_CONTEXT          0xFF
+#define STACK_STATS_WARN_NUM            7           // warn when 7/8 of a stack is used
+#define STACK_STATS_WARN_DEN            8
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    TX_THREAD      *p_thread;
+    uint32_t       *p_start;                    // lowest word of the stack
+    uint16_t        size;                       // bytes
+    uint16_t        high_water;                 // bytes
+    uint8_t         flags;                      // STACK_STATS_FLAG_xxx
+} stack_stats_context_t;
+
+typedef struct
+{
+    uint8_t         context;                    // index in contexts, STACK_STATS_NO_CONTEXT if not run in a thread
+    uint16_t        high_water;                 // bytes
+    uint32_t        calls;
+} stack_stats_callback_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static stack_stats_context_t *stack_stats_context(void);
+static uint16_t stack_stats_sample(stack_stats_context_t *p_ctx);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static stack_stats_context_t  stack_stats_contexts[STACK_STATS_MAX_CONTEXTS];
+static stack_stats_callback_t stack_stats_callbacks[STACK_STATS_CALLBACKS];
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Callback is entered. The depth reached since the last scan is charged to the thread.
+ */
+void stack_stats_enter(uint8_t callback)
+{
+    stack_stats_context_t *p_ctx = stack_stats_context();
+
+    stack_stats_callbacks[callback].calls++;
+    if (p_ctx == NULL)
+    {
+        stack_stats_callbacks[callback].context = STACK_STATS_NO_CONTEXT;
+        return;
+    }
+    stack_stats_callbacks[callback].context = (uint8_t)(p_ctx - stack_stats_contexts);
+    stack_stats_sample(p_ctx);
+}
+
+/*
+ * Callback returns, the depth reached since stack_stats_enter is charged to the callback
+ */
+void stack_stats_exit(uint8_t callback)
+{
+    stack_stats_context_t *p_ctx = stack_stats_context();
+    uint16_t used;
+
+    if (p_ctx == NULL)
+        return;
+
+    used = stack_stats_sample(p_ctx);
+    if (used > stack_stats_callbacks[callback].high_water)
+    {
+        stack_stats_callbacks[callback].high_water = used;
+        if (used * STACK_STATS_WARN_DEN > p_ctx->size * STACK_STATS_WARN_NUM)
+            WICED_BT_TRACE("stack: callback %d used %d of %d bytes\n", callback, used, p_ctx->size);
+    }
+}
+
+/*
+ * Find the context of the current thread, painting the stack of a new one.
+ * Returns NULL outside of a thread or when the table is full.
+ */
+static stack_stats_context_t *stack_stats_context(void)
+{
+    TX_THREAD *p_thread = tx_thread_identify();
+    stack_stats_context_t *p_free = NULL;
+    uint32_t *p_word, *p_limit;
+    uint32_t marker;
+    int i;
+
+    if (p_thread == NULL)
+        return NULL;
+
+    for (i = 0; i < STACK_STATS_MAX_CONTEXTS; i++)
+    {
+        if (stack_stats_contexts[i].p_thread == p_thread)
+            return &stack_stats_contexts[i];
+        if ((stack_stats_contexts[i].p_thread == NULL) && (p_free == NULL))
+            p_free = &stack_stats_contexts[i];
+    }
+    if (p_free == NULL)
+        return NULL;
+
+    p_free->p_thread   = p_thread;
+    p_free->p_start    = (uint32_t *)p_thread->tx_thread_stack_start;
+    p_free->size       = (uint16_t)p_thread->tx_thread_stack_size;
+    p_free->high_water = 0;
+    p_free->flags      = 0;
+
+    // Paint from the stack start up to the margin below the current stack pointer
+    p_limit = (uint32_t *)((uint8_t *)&marker - STACK_STATS_MARGIN);
+    for (p_word = p_free->p_start; p_word < p_limit; p_word++)
+        *p_word = STACK_STATS_PAINT;
+
+    WICED_BT_TRACE("stack: thread %s size:%d\n", p_thread->tx_thread_name, p_free->size);
+    return p_free;
+}
+
+/*
+ * Find the deepest point reached since the last sample and paint the used part again.
+ * Returns bytes used.
+ */
+static uint16_t stack_stats_sample(stack_stats_context_t *p_ctx)
+{
+    uint32_t *p_word = p_ctx->p_start;
+    uint32_t *p_end  = (uint32_t *)((uint8_t *)p_ctx->p_start + p_ctx->size);
+    uint32_t *p_limit, *p_low;
+    uint32_t marker;
+    uint16_t used;
+
+    while ((p_word < p_end) && (*p_word == STACK_STATS_PAINT))
+        p_word++;
+    p_low = p_word;
+
+    used = (uint16_t)((uint8_t *)p_end - (uint8_t *)p_low);
+    if (used > p_ctx->high_water)
+        p_ctx->high_water = used;
+
+    // Paint at the very start was overwritten, the stack overflowed or is about to
+    if (p_low == p_ctx->p_start)
+    {
+        if (!(p_ctx->flags & STACK_STATS_FLAG_OVERFLOW))
+            WICED_BT_TRACE("stack: thread %s overflow\n", p_ctx->p_thread->tx_thread_name);
+        p_ctx->flags |= STACK_STATS_FLAG_OVERFLOW;
+    }
+    else if (used * STACK_STATS_WARN_DEN > p_ctx->size * STACK_STATS_WARN_NUM)
+    {
+        p_ctx->flags |= STACK_STATS_FLAG_NEAR_FULL;
+    }
+
+    p_limit = (uint32_t *)((uint8_t *)&marker - STACK_STATS_MARGIN);
+    for (p_word = p_low; p_word < p_limit; p_word++)
+        *p_word = STACK_STATS_PAINT;
+
+    return used;
+}
+
+/*
+ * Clear the high-water marks, the stacks stay painted
+ */
+void stack_stats_reset(void)
+{
+    int i;
+
+    for (i = 0; i < STACK_STATS_MAX_CONTEXTS; i++)
+    {
+        stack_stats_contexts[i].high_water = 0;
+        stack_stats_contexts[i].flags      = 0;
+    }
+    for (i = 0; i < STACK_STATS_CALLBACKS; i++)
+    {
+        stack_stats_callbacks[i].high_water = 0;
+        stack_stats_callbacks[i].calls      = 0;
+    }
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t stack_stats_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+    int i;
+
+    UINT8_TO_STREAM(p, STACK_STATS_MAX_CONTEXTS);
+    for (i = 0; i < STACK_STATS_MAX_CONTEXTS; i++)
+    {
+        UINT16_TO_STREAM(p, stack_stats_contexts[i].size);
+        UINT16_TO_STREAM(p, stack_stats_contexts[i].high_water);
+        UINT8_TO_STREAM(p, stack_stats_contexts[i].flags);
+    }
+    for (i = 0; i < STACK_STATS_CALLBACKS; i++)
+    {
+        UINT8_TO_STREAM(p, stack_stats_callbacks[i].context);
+        UINT16_TO_STREAM(p, stack_stats_callbacks[i].high_water);
+        UINT32_TO_STREAM(p, stack_stats_callbacks[i].calls);
+    }
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Send the statistics to the host
+ */
+void stack_stats_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[STACK_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_STACK_STATS, buffer, stack_stats_serialize_stats(buffer));
+#endif
+}
+
+#endif // STACK_STATS
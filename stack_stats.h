@@ -0,0 +1,100 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Stack high-water marks of the application callbacks API definition
+ */
+
+#ifndef __STACK_STATS__H
+#define __STACK_STATS__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Instrumented callbacks
+ */
+#define STACK_STATS_CB_MESSAGE_HANDLER      0   // model message handler
+#define STACK_STATS_CB_HCI_COMMAND          1   // WICED HCI command
+#define STACK_STATS_CB_SLEEP_POLL           2   // sleep permission poll, LPN
+#define STACK_STATS_CB_WAKEUP_TIMER         3   // wake up timer, LPN
+#define STACK_STATS_CB_LPN_EVENT            4   // poll cycle event of the mesh core, LPN
+#define STACK_STATS_CALLBACKS               5
+
+#define STACK_STATS_MAX_CONTEXTS            4   // threads tracked
+
+/*
+ * Context flags
+ */
+#define STACK_STATS_FLAG_NEAR_FULL          0x01    // more than 7/8 of the stack used
+#define STACK_STATS_FLAG_OVERFLOW           0x02    // the whole stack used, memory below may be corrupted
+
+/*
+ * Serialized statistics, little endian
+ *   number of contexts (1), for each context the stack size and high-water mark in bytes
+ *   (2 each) and the flags (1), then for each callback the context index (1, 0xFF if not run
+ *   in a thread), the high-water mark in bytes (2) and the number of calls (4)
+ */
+#define STACK_STATS_LEN                     (1 + STACK_STATS_MAX_CONTEXTS * (2 + 2 + 1) + STACK_STATS_CALLBACKS * (1 + 2 + 4))
+
+/*
+ * Callback is entered
+ */
+void stack_stats_enter(uint8_t callback);
+
+/*
+ * Callback returns
+ */
+void stack_stats_exit(uint8_t callback);
+
+/*
+ * Clear the high-water marks
+ */
+void stack_stats_reset(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t stack_stats_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Send the statistics to the host
+ */
+void stack_stats_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
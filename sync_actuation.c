@@ -0,0 +1,530 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ *
+ * Synchronized actuation. Nodes which receive a group command at different times,
+ * for example low power nodes polling their friends at different phases, apply the
+ * new state at the same absolute time carried in the command.
+ *
+ * The time base is maintained with the vendor Time messages. A time master (for example
+ * the provisioner) distributes its TAI time in the Time Set message. Nodes that receive
+ * the message directly use it as is. A low power node receives the message from the
+ * friend cache with unknown delay, so it refines the clock with a Time Get / Time Status
+ * exchange and compensates half of the round trip time.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "wiced_hal_nvram.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_vendor.h"
+#include "sync_actuation.h"
+#include "nvram_wear.h"
+#ifdef PREDICTIVE_POLL
+#include "predictive_poll.h"
+#endif
+
+#ifdef SYNC_ACTUATION_SUPPORTED
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define SYNC_ACTUATION_TAI_LEN                  6                       // TAI time in milliseconds, little endian
+#define SYNC_ACTUATION_TIME_MSG_LEN             (SYNC_ACTUATION_TAI_LEN + 2)
+#define SYNC_ACTUATION_ONOFF_SET_LEN            (2 + SYNC_ACTUATION_TAI_LEN)
+#define SYNC_ACTUATION_ONOFF_STATUS_LEN         7
+
+#define SYNC_ACTUATION_CLOCK_MAX_AGE            (60 * 60 * 1000)        // low power node refreshes the clock every hour
+#define SYNC_ACTUATION_CLOCK_DRIFT_PPM          50                      // worst case drift of the sleep clock
+#define SYNC_ACTUATION_TIME_GET_MAX_RTT         3000                    // Time Status received later is not used
+#define SYNC_ACTUATION_DIRECT_UNCERTAINTY       50                      // added to the Time Set received directly
+#define SYNC_ACTUATION_MAX_DELAY                (24 * 60 * 60 * 1000)   // target time can be at most one day ahead
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint16_t        master_addr;            // address of the time master, 0 if not known
+    uint16_t        master_app_key_idx;     // application key used by the time master
+} sync_actuation_nvram_t;
+
+typedef struct
+{
+    wiced_bool_t    clock_synced;
+    uint64_t        ref_tai_ms;             // TAI time at the reference point
+    uint64_t        ref_local_us;           // local time at the reference point
+    uint16_t        ref_uncertainty;        // uncertainty of the reference in milliseconds
+    uint64_t        time_get_sent_us;       // local time when Time Get was sent, 0 if no request is outstanding
+    sync_actuation_nvram_t nvram;
+
+    wiced_bool_t    action_pending;
+    uint8_t         action_onoff;
+    uint64_t        action_tai_ms;
+    uint16_t        last_src;
+    uint8_t         last_tid;
+    wiced_bool_t    timer_initialized;
+    wiced_timer_t   action_timer;
+} sync_actuation_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static wiced_bool_t sync_actuation_get_tai(uint64_t *p_tai_ms, uint16_t *p_uncertainty);
+static void sync_actuation_set_clock(uint64_t tai_ms, uint64_t local_us, uint16_t uncertainty);
+static void sync_actuation_set_master(uint16_t addr, uint16_t app_key_idx);
+static void sync_actuation_send_time_get(void);
+static void sync_actuation_process_time_get(wiced_bt_mesh_event_t *p_event);
+static void sync_actuation_process_time_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+static void sync_actuation_process_time_status(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+static void sync_actuation_process_onoff_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+static void sync_actuation_send_onoff_status(wiced_bt_mesh_event_t *p_event, uint8_t result, int32_t slack);
+static void sync_actuation_timer_cb(TIMER_PARAM_TYPE arg);
+static uint64_t sync_actuation_read_tai(uint8_t *p);
+static uint8_t *sync_actuation_write_tai(uint8_t *p, uint64_t tai_ms);
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+#endif
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+extern wiced_bt_mesh_core_config_t mesh_config;
+
+static sync_actuation_state_t sync_actuation = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Initialize synchronized actuation
+ */
+void sync_actuation_init(wiced_bool_t is_provisioned)
+{
+    wiced_result_t result;
+
+    if (!sync_actuation.timer_initialized)
+    {
+        wiced_init_timer(&sync_actuation.action_timer, sync_actuation_timer_cb, 0, WICED_MILLI_SECONDS_TIMER);
+        sync_actuation.timer_initialized = WICED_TRUE;
+    }
+
+    if (!is_provisioned)
+    {
+        memset(&sync_actuation.nvram, 0, sizeof(sync_actuation.nvram));
+        return;
+    }
+
+    if (wiced_hal_read_nvram(LOW_POWER_LED_NVRAM_ID_SYNC_ACTUATION, sizeof(sync_actuation.nvram), (uint8_t *)&sync_actuation.nvram, &result) != sizeof(sync_actuation.nvram))
+    {
+        memset(&sync_actuation.nvram, 0, sizeof(sync_actuation.nvram));
+    }
+    WICED_BT_TRACE("sync init master:%04x synced:%d\n", sync_actuation.nvram.master_addr, sync_actuation.clock_synced);
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    // Clock is lost after HID-off, ask the time master if it is known
+    if (!sync_actuation.clock_synced)
+        sync_actuation_send_time_get();
+#endif
+}
+
+/*
+ * Process Time and Synchronized OnOff vendor messages. The function takes ownership of the p_event.
+ */
+void sync_actuation_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    switch (p_event->opcode)
+    {
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_GET:
+        sync_actuation_process_time_get(p_event);
+        break;
+
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_SET:
+        sync_actuation_process_time_set(p_event, p_data, data_len);
+        break;
+
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_STATUS:
+        sync_actuation_process_time_status(p_event, p_data, data_len);
+        break;
+
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET:
+    case MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET_UNACKED:
+        sync_actuation_process_onoff_set(p_event, p_data, data_len);
+        break;
+
+    default:
+        wiced_bt_mesh_release_event(p_event);
+        break;
+    }
+}
+
+/*
+ * Returns current TAI time in milliseconds if the clock is synchronized
+ */
+wiced_bool_t sync_actuation_get_time(uint64_t *p_tai_ms)
+{
+    uint16_t uncertainty;
+
+    return sync_actuation_get_tai(p_tai_ms, &uncertainty);
+}
+
+/*
+ * Returns number of milliseconds until the pending action, or SYNC_ACTUATION_NO_ACTION
+ */
+uint32_t sync_actuation_time_to_action(void)
+{
+    uint64_t now_tai;
+    uint16_t uncertainty;
+
+    if (!sync_actuation.action_pending || !sync_actuation_get_tai(&now_tai, &uncertainty))
+        return SYNC_ACTUATION_NO_ACTION;
+
+    return (sync_actuation.action_tai_ms > now_tai) ? (uint32_t)(sync_actuation.action_tai_ms - now_tai) : 0;
+}
+
+/*
+ * Called by the low power node when it wakes up, refreshes the clock if it is getting stale
+ */
+void sync_actuation_lpn_wake(void)
+{
+    uint64_t age_ms = (clock_SystemTimeMicroseconds64() - sync_actuation.ref_local_us) / 1000;
+
+    if (!sync_actuation.clock_synced || (age_ms > SYNC_ACTUATION_CLOCK_MAX_AGE))
+        sync_actuation_send_time_get();
+}
+
+/*
+ * Returns current TAI time estimate and its uncertainty. Uncertainty grows with the sleep clock drift.
+ */
+static wiced_bool_t sync_actuation_get_tai(uint64_t *p_tai_ms, uint16_t *p_uncertainty)
+{
+    uint64_t elapsed_us;
+    uint32_t uncertainty;
+
+    if (!sync_actuation.clock_synced)
+        return WICED_FALSE;
+
+    elapsed_us = clock_SystemTimeMicroseconds64() - sync_actuation.ref_local_us;
+    uncertainty = sync_actuation.ref_uncertainty + (uint32_t)((elapsed_us / 1000) * SYNC_ACTUATION_CLOCK_DRIFT_PPM / 1000000);
+
+    *p_tai_ms      = sync_actuation.ref_tai_ms + elapsed_us / 1000;
+    *p_uncertainty = (uncertainty > 0xffff) ? 0xffff : (uint16_t)uncertainty;
+    return WICED_TRUE;
+}
+
+/*
+ * Set new clock reference. A pending action timer is restarted because the remaining time can change.
+ */
+static void sync_actuation_set_clock(uint64_t tai_ms, uint64_t local_us, uint16_t uncertainty)
+{
+    sync_actuation.ref_tai_ms      = tai_ms;
+    sync_actuation.ref_local_us    = local_us;
+    sync_actuation.ref_uncertainty = uncertainty;
+    sync_actuation.clock_synced    = WICED_TRUE;
+
+    WICED_BT_TRACE("sync clock set uncertainty:%d\n", uncertainty);
+
+    if (sync_actuation.action_pending)
+    {
+        wiced_stop_timer(&sync_actuation.action_timer);
+        wiced_start_timer(&sync_actuation.action_timer, sync_actuation_time_to_action());
+    }
+}
+
+/*
+ * Remember the time master, the address is saved in NVRAM so that the node can ask for time after HID-off
+ */
+static void sync_actuation_set_master(uint16_t addr, uint16_t app_key_idx)
+{
+    wiced_result_t result;
+
+    if ((sync_actuation.nvram.master_addr == addr) && (sync_actuation.nvram.master_app_key_idx == app_key_idx))
+        return;
+
+    sync_actuation.nvram.master_addr        = addr;
+    sync_actuation.nvram.master_app_key_idx = app_key_idx;
+
+    nvram_wear_write_nvram(LOW_POWER_LED_NVRAM_ID_SYNC_ACTUATION, sizeof(sync_actuation.nvram), (uint8_t *)&sync_actuation.nvram, &result);
+    WICED_BT_TRACE("sync master:%04x nvram write result:%d\n", addr, result);
+}
+
+/*
+ * Request time from the time master
+ */
+static void sync_actuation_send_time_get(void)
+{
+    if (sync_actuation.nvram.master_addr == 0)
+        return;
+
+    sync_actuation.time_get_sent_us = clock_SystemTimeMicroseconds64();
+    mesh_low_power_led_vendor_send_to(sync_actuation.nvram.master_addr, sync_actuation.nvram.master_app_key_idx,
+                                      MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_GET, NULL, 0);
+}
+
+/*
+ * Reply with the local time. A node which has no time does not reply.
+ */
+static void sync_actuation_process_time_get(wiced_bt_mesh_event_t *p_event)
+{
+    uint8_t  buffer[SYNC_ACTUATION_TIME_MSG_LEN];
+    uint8_t *p = buffer;
+    uint64_t tai_ms;
+    uint16_t uncertainty;
+
+    if (!sync_actuation_get_tai(&tai_ms, &uncertainty))
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    p = sync_actuation_write_tai(p, tai_ms);
+    *p++ = (uint8_t)uncertainty;
+    *p++ = (uint8_t)(uncertainty >> 8);
+
+    mesh_low_power_led_vendor_send(wiced_bt_mesh_create_reply_event(p_event), MESH_LOW_POWER_LED_VENDOR_OPCODE_TIME_STATUS, buffer, (uint16_t)(p - buffer));
+}
+
+/*
+ * Time master distributes its time
+ */
+static void sync_actuation_process_time_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    uint64_t tai_ms;
+    uint16_t uncertainty;
+
+    if (data_len != SYNC_ACTUATION_TIME_MSG_LEN)
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    tai_ms      = sync_actuation_read_tai(p_data);
+    uncertainty = p_data[SYNC_ACTUATION_TAI_LEN] | (p_data[SYNC_ACTUATION_TAI_LEN + 1] << 8);
+
+    sync_actuation_set_master(p_event->src, p_event->app_key_idx);
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    // The message could wait in the friend cache up to the poll timeout. Use it only as a
+    // coarse time and refine with the Time Get which is answered within the receive window.
+    if (!sync_actuation.clock_synced)
+    {
+        uint32_t coarse = uncertainty + (uint32_t)mesh_config.low_power.poll_timeout * 100;
+        sync_actuation_set_clock(tai_ms, clock_SystemTimeMicroseconds64(), (coarse > 0xffff) ? 0xffff : (uint16_t)coarse);
+    }
+    sync_actuation_send_time_get();
+#else
+    sync_actuation_set_clock(tai_ms, clock_SystemTimeMicroseconds64(), uncertainty + SYNC_ACTUATION_DIRECT_UNCERTAINTY);
+#endif
+    wiced_bt_mesh_release_event(p_event);
+}
+
+/*
+ * Time master replied to our Time Get. Half of the round trip is used as the transfer delay.
+ */
+static void sync_actuation_process_time_status(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    uint64_t now_us = clock_SystemTimeMicroseconds64();
+    uint32_t rtt_ms;
+    uint32_t uncertainty;
+
+    if ((data_len != SYNC_ACTUATION_TIME_MSG_LEN) || (sync_actuation.time_get_sent_us == 0))
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    rtt_ms = (uint32_t)((now_us - sync_actuation.time_get_sent_us) / 1000);
+    sync_actuation.time_get_sent_us = 0;
+
+    WICED_BT_TRACE("sync time status rtt:%d\n", rtt_ms);
+
+    if (rtt_ms <= SYNC_ACTUATION_TIME_GET_MAX_RTT)
+    {
+        uncertainty = (p_data[SYNC_ACTUATION_TAI_LEN] | (p_data[SYNC_ACTUATION_TAI_LEN + 1] << 8)) + rtt_ms / 2;
+        sync_actuation_set_clock(sync_actuation_read_tai(p_data) + rtt_ms / 2, now_us, (uint16_t)uncertainty);
+    }
+    wiced_bt_mesh_release_event(p_event);
+}
+
+/*
+ * Process Synchronized OnOff Set. The new state is applied at the target time or immediately if
+ * the target time already passed or the node does not have the time.
+ */
+static void sync_actuation_process_onoff_set(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len)
+{
+    uint64_t target_tai;
+    uint64_t now_tai;
+    uint16_t uncertainty;
+    uint8_t  result;
+    int32_t  slack = 0;
+
+    if ((data_len != SYNC_ACTUATION_ONOFF_SET_LEN) || (p_data[0] > 1))
+    {
+        wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    target_tai = sync_actuation_read_tai(&p_data[2]);
+
+    // Retransmission of the same command, just reply with the current status if the reply is required
+    if ((p_event->src == sync_actuation.last_src) && (p_data[1] == sync_actuation.last_tid) && (target_tai == sync_actuation.action_tai_ms))
+    {
+        result = sync_actuation.action_pending ? SYNC_ACTUATION_RESULT_SCHEDULED : SYNC_ACTUATION_RESULT_LATE;
+        if (p_event->opcode == MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET)
+            sync_actuation_send_onoff_status(p_event, result, 0);
+        else
+            wiced_bt_mesh_release_event(p_event);
+        return;
+    }
+    sync_actuation.last_src = p_event->src;
+    sync_actuation.last_tid = p_data[1];
+
+#if defined(PREDICTIVE_POLL) && defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1)
+    predictive_poll_record_command();
+#endif
+
+    if (!sync_actuation_get_tai(&now_tai, &uncertainty))
+    {
+        result = SYNC_ACTUATION_RESULT_NOT_SYNCED;
+    }
+    else if (target_tai <= now_tai)
+    {
+        result = SYNC_ACTUATION_RESULT_LATE;
+        slack  = (now_tai - target_tai > 0x7fffffff) ? (int32_t)0x80000001 : -(int32_t)(now_tai - target_tai);
+    }
+    else if (target_tai - now_tai > SYNC_ACTUATION_MAX_DELAY)
+    {
+        result = SYNC_ACTUATION_RESULT_OUT_OF_RANGE;
+    }
+    // Scheduled whatever the slack, a node which rejected a short lead would switch apart from
+    // the nodes of the group which polled earlier. The slack tells the sender how close it was.
+    else
+    {
+        result = SYNC_ACTUATION_RESULT_SCHEDULED;
+        slack  = (int32_t)(target_tai - now_tai);
+    }
+    WICED_BT_TRACE("sync onoff:%d result:%d slack:%d\n", p_data[0], result, slack);
+
+    if (result != SYNC_ACTUATION_RESULT_OUT_OF_RANGE)
+    {
+        wiced_stop_timer(&sync_actuation.action_timer);
+        sync_actuation.action_onoff  = p_data[0];
+        sync_actuation.action_tai_ms = target_tai;
+
+        if (result == SYNC_ACTUATION_RESULT_SCHEDULED)
+        {
+            sync_actuation.action_pending = WICED_TRUE;
+            wiced_start_timer(&sync_actuation.action_timer, (uint32_t)slack);
+        }
+        else
+        {
+            sync_actuation.action_pending = WICED_FALSE;
+            mesh_low_power_led_set_onoff(sync_actuation.action_onoff);
+        }
+    }
+
+    if (p_event->opcode == MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_SET)
+        sync_actuation_send_onoff_status(p_event, result, slack);
+    else
+        wiced_bt_mesh_release_event(p_event);
+}
+
+/*
+ * Send Synchronized OnOff Status as a reply to the Synchronized OnOff Set
+ */
+static void sync_actuation_send_onoff_status(wiced_bt_mesh_event_t *p_event, uint8_t result, int32_t slack)
+{
+    uint8_t  buffer[SYNC_ACTUATION_ONOFF_STATUS_LEN];
+    uint8_t *p = buffer;
+
+    *p++ = mesh_low_power_led_get_onoff();
+    *p++ = sync_actuation.action_onoff;
+    *p++ = result;
+    *p++ = (uint8_t)slack;
+    *p++ = (uint8_t)(slack >> 8);
+    *p++ = (uint8_t)(slack >> 16);
+    *p++ = (uint8_t)(slack >> 24);
+
+    mesh_low_power_led_vendor_send(wiced_bt_mesh_create_reply_event(p_event), MESH_LOW_POWER_LED_VENDOR_OPCODE_SYNC_ONOFF_STATUS, buffer, (uint16_t)(p - buffer));
+}
+
+/*
+ * Action timer callback. The clock could be adjusted while the timer was running, so check the time again.
+ */
+static void sync_actuation_timer_cb(TIMER_PARAM_TYPE arg)
+{
+    uint32_t remaining = sync_actuation_time_to_action();
+
+    if (!sync_actuation.action_pending)
+        return;
+
+    if ((remaining != SYNC_ACTUATION_NO_ACTION) && (remaining != 0))
+    {
+        wiced_start_timer(&sync_actuation.action_timer, remaining);
+        return;
+    }
+    WICED_BT_TRACE("sync apply onoff:%d\n", sync_actuation.action_onoff);
+
+    sync_actuation.action_pending = WICED_FALSE;
+    mesh_low_power_led_set_onoff(sync_actuation.action_onoff);
+
+#if defined(LOW_POWER_NODE) && (LOW_POWER_NODE == 1) && defined(LPN_POLL_MERGE)
+    // Node is awake anyway, poll the friend if the poll is due soon
+    mesh_low_power_led_local_wake();
+#endif
+}
+
+static uint64_t sync_actuation_read_tai(uint8_t *p)
+{
+    uint64_t tai_ms = 0;
+    int      i;
+
+    for (i = SYNC_ACTUATION_TAI_LEN - 1; i >= 0; i--)
+        tai_ms = (tai_ms << 8) | p[i];
+    return tai_ms;
+}
+
+static uint8_t *sync_actuation_write_tai(uint8_t *p, uint64_t tai_ms)
+{
+    int i;
+
+    for (i = 0; i < SYNC_ACTUATION_TAI_LEN; i++)
+    {
+        *p++ = (uint8_t)tai_ms;
+        tai_ms >>= 8;
+    }
+    return p;
+}
+
+#endif // SYNC_ACTUATION_SUPPORTED
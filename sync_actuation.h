@@ -0,0 +1,83 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+
+/** @file
+ * Synchronized actuation API definition
+ */
+
+#ifndef __SYNC_ACTUATION__H
+#define __SYNC_ACTUATION__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SYNC_ACTUATION_NO_ACTION                0xFFFFFFFF
+
+// Result reported in the Synchronized OnOff Status message
+#define SYNC_ACTUATION_RESULT_SCHEDULED         0   // new state will be applied at the target time
+#define SYNC_ACTUATION_RESULT_LATE              1   // target time already passed, state applied immediately
+#define SYNC_ACTUATION_RESULT_NOT_SYNCED        2   // local clock is not synchronized, state applied immediately
+#define SYNC_ACTUATION_RESULT_OUT_OF_RANGE      3   // target time is too far in the future, message ignored
+
+/*
+ * Initialize synchronized actuation
+ */
+void sync_actuation_init(wiced_bool_t is_provisioned);
+
+/*
+ * Process Time and Synchronized OnOff vendor messages. The function takes ownership of the p_event.
+ */
+void sync_actuation_process_vendor_msg(wiced_bt_mesh_event_t *p_event, uint8_t *p_data, uint16_t data_len);
+
+/*
+ * Returns current TAI time in milliseconds if the clock is synchronized
+ */
+wiced_bool_t sync_actuation_get_time(uint64_t *p_tai_ms);
+
+/*
+ * Returns number of milliseconds until the pending action, or SYNC_ACTUATION_NO_ACTION
+ */
+uint32_t sync_actuation_time_to_action(void);
+
+/*
+ * Called by the low power node when it wakes up, refreshes the clock if it is getting stale
+ */
+void sync_actuation_lpn_wake(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""
+Comparison of the experiment cohorts of low power nodes.
+
+Reads COHORT records (cohort.h), the payload of WICED HCI event 0xE08F or of the vendor Cohort
+Status message, one line per node: a node label, e.g. the unicast address, followed by the
+record as hex bytes.  For each node it derives the mean poll interval, the awake time per poll
+cycle, the average current and battery life with the energy model of tools/mesh_sim, and the
+mean and maximum delivery latency of a message held by the friend, which the node derives from
+the measured intervals between its polls.  The nodes are the experimental
+units: each cohort is summarized by the mean and standard deviation over its nodes and every
+cohort is compared with the control cohort 0 with Welch's t-test, giving the difference, its
+95% confidence interval and the p-value.
+
+    python3 cohort_report.py records/example.txt
+"""
+
+import argparse
+import collections
+import math
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "mesh_sim"))
+from mesh_sim.energy import EnergyModel  # noqa: E402
+
+SOURCES = {0: "hash", 1: "provisioner"}
+HEADER = struct.Struct("<HBBB")
+STATS = struct.Struct("<BBIIIIII")
+RECORD_LEN = HEADER.size + 3 + STATS.size
+
+# Metric name, unit, format, True if lower is better
+METRICS = [
+    ("current_ua", "uA", "%.2f", True),
+    ("battery_days", "days", "%.0f", False),
+    ("awake_ms", "ms/poll", "%.2f", True),
+    ("interval_s", "s", "%.2f", None),
+    ("latency_s", "s", "%.2f", True),
+    ("latency_max_s", "s", "%.2f", True),
+]
+
+
+def parse_record(data):
+    if len(data) < RECORD_LEN:
+        raise ValueError("record too short, %d bytes" % len(data))
+    experiment, cohort, source, early_sleep = HEADER.unpack_from(data, 0)
+    poll_timeout = int.from_bytes(data[HEADER.size:HEADER.size + 3], "little")
+    (transmit_count, receive_delay, cycles, awake_10us, sleep_ms, messages,
+     latency_mean_ms, latency_max_ms) = STATS.unpack_from(data, HEADER.size + 3)
+    return dict(experiment=experiment, cohort=cohort, source=SOURCES.get(source, str(source)),
+                early_sleep=early_sleep, poll_timeout=poll_timeout, transmit_count=transmit_count,
+                receive_delay=receive_delay, cycles=cycles, awake_s=awake_10us / 1e5,
+                sleep_s=sleep_ms / 1e3, messages=messages, latency_s=latency_mean_ms / 1e3,
+                latency_max_s=latency_max_ms / 1e3)
+
+
+def read_records(paths):
+    """Lines of '<node> <hex>', hex bytes optionally separated by spaces or colons, # comments."""
+    nodes = {}
+    for path in paths:
+        with open(path) as f:
+            for lineno, line in enumerate(f, 1):
+                fields = line.split("#", 1)[0].split(None, 1)
+                if not fields:
+                    continue
+                if len(fields) != 2:
+                    sys.exit("%s:%d: expected node and record" % (path, lineno))
+                try:
+                    record = parse_record(bytes.fromhex(fields[1].replace(":", "").replace(" ", "").strip()))
+                except ValueError as e:
+                    sys.exit("%s:%d: %s" % (path, lineno, e))
+                # The last record of a node wins, the counters only grow
+                nodes[fields[0]] = record
+    return nodes
+
+
+def node_metrics(r, model):
+    duration_s = r["awake_s"] + r["sleep_s"]
+    interval_s = duration_s / r["cycles"]
+    # Awake time is mostly the receive window, the wake up overhead is not in the measurement
+    charge = (r["awake_s"] * model.rx_ua + r["sleep_s"] * model.sleep_ua
+              + r["cycles"] * model.wake_us * 1e-6 * model.active_ua)
+    current_ua = charge / duration_s
+    return dict(current_ua=current_ua, battery_days=model.battery_days(current_ua),
+                awake_ms=r["awake_s"] * 1e3 / r["cycles"], interval_s=interval_s,
+                latency_s=r["latency_s"], latency_max_s=r["latency_max_s"],
+                messages_h=r["messages"] * 3600.0 / duration_s, hours=duration_s / 3600.0)
+
+
+def _betacf(a, b, x):
+    """Continued fraction of the incomplete beta function (Numerical Recipes 6.4)."""
+    tiny = 1e-300
+    qab, qap, qam = a + b, a + 1.0, a - 1.0
+    c, d = 1.0, 1.0 - qab * x / qap
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 300):
+        m2 = 2 * m
+        for aa in (m * (b - m) * x / ((qam + m2) * (a + m2)), -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))):
+            d = 1.0 + aa * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + aa / c
+            c = c if abs(c) > tiny else tiny
+            h *= d * c
+        if abs(d * c - 1.0) < 1e-12:
+            break
+    return h
+
+
+def _betai(a, b, x):
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) + a * math.log(x) + b * math.log(1.0 - x))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * _betacf(a, b, x) / a
+    return 1.0 - front * _betacf(b, a, 1.0 - x) / b
+
+
+def t_two_sided_p(t, df):
+    return _betai(df / 2.0, 0.5, df / (df + t * t))
+
+
+def t_critical(df, alpha=0.05):
+    lo, hi = 0.0, 1000.0
+    for _ in range(100):
+        mid = (lo + hi) / 2
+        if t_two_sided_p(mid, df) > alpha:
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+
+def mean_sd(values):
+    n = len(values)
+    mean = sum(values) / n
+    var = sum((v - mean) ** 2 for v in values) / (n - 1) if n > 1 else 0.0
+    return mean, math.sqrt(var)
+
+
+def welch(control, variant):
+    """Returns (difference, half width of the 95% CI, p-value) or None with too few nodes."""
+    if len(control) < 2 or len(variant) < 2:
+        return None
+    m1, s1 = mean_sd(control)
+    m2, s2 = mean_sd(variant)
+    v1, v2 = s1 * s1 / len(control), s2 * s2 / len(variant)
+    diff = m2 - m1
+    se = math.sqrt(v1 + v2)
+    if se == 0.0:
+        return diff, 0.0, 0.0 if diff else 1.0
+    df = (v1 + v2) ** 2 / ((v1 * v1 / (len(control) - 1) if v1 else 0.0) + (v2 * v2 / (len(variant) - 1) if v2 else 0.0))
+    return diff, t_critical(df) * se, t_two_sided_p(diff / se, df)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("records", nargs="+", help="files of '<node> <hex record>' lines")
+    parser.add_argument("--experiment", type=int, help="experiment to report (default: the most common)")
+    parser.add_argument("--min-hours", type=float, default=24.0, help="leave out nodes measured for less time")
+    parser.add_argument("--nodes", action="store_true", help="print the metrics of each node")
+    args = parser.parse_args()
+
+    nodes = read_records(args.records)
+    if not nodes:
+        sys.exit("no records")
+    experiment = args.experiment
+    if experiment is None:
+        experiment = collections.Counter(r["experiment"] for r in nodes.values()).most_common(1)[0][0]
+
+    model = EnergyModel()
+    cohorts = collections.defaultdict(list)
+    params = {}
+    skipped = 0
+    for node, r in sorted(nodes.items()):
+        if r["experiment"] != experiment:
+            skipped += 1
+            continue
+        if r["cycles"] == 0 or node_metrics(r, model)["hours"] < args.min_hours:
+            print("%s: measured for less than %.0f hours, left out" % (node, args.min_hours))
+            continue
+        key = (r["early_sleep"], r["poll_timeout"], r["transmit_count"])
+        if params.setdefault(r["cohort"], key) != key:
+            print("%s: cohort %d with other parameters than its cohort, check the firmware version" % (node, r["cohort"]))
+        m = node_metrics(r, model)
+        cohorts[r["cohort"]].append(m)
+        if args.nodes:
+            print("%-12s cohort %d %-11s %7.1f h %8.2f uA %7.2f ms/poll %7.2f s interval %6.1f msg/h"
+                  % (node, r["cohort"], r["source"], m["hours"], m["current_ua"], m["awake_ms"], m["interval_s"], m["messages_h"]))
+    if skipped:
+        print("%d nodes of other experiments left out" % skipped)
+    if not cohorts:
+        sys.exit("no nodes in experiment %d" % experiment)
+
+    print("\nExperiment %d" % experiment)
+    print("%-6s %5s %6s %12s %8s %8s" % ("cohort", "nodes", "early", "poll timeout", "tx count", "msg/h"))
+    for c in sorted(cohorts):
+        early, poll_timeout, transmit_count = params[c]
+        print("%-6d %5d %6s %10.1f s %8s %8.1f" % (c, len(cohorts[c]), "yes" if early else "no", poll_timeout / 10.0,
+                                                   transmit_count or "config", mean_sd([m["messages_h"] for m in cohorts[c]])[0]))
+
+    for name, unit, fmt, lower_better in METRICS:
+        print("\n%s (%s)" % (name, unit))
+        control = [m[name] for m in cohorts.get(0, [])]
+        for c in sorted(cohorts):
+            values = [m[name] for m in cohorts[c]]
+            mean, sd = mean_sd(values)
+            line = ("  cohort %d  mean " + fmt + "  sd " + fmt) % (c, mean, sd)
+            result = welch(control, values) if c != 0 else None
+            if result:
+                diff, half, p = result
+                line += ("  vs 0: %+" + fmt[1:] + " [%+" + fmt[1:] + ", %+" + fmt[1:] + "]  p=%.3f") % (diff, diff - half, diff + half, p)
+                if p < 0.05 and lower_better is not None:
+                    line += "  better" if (diff < 0) == lower_better else "  worse"
+            elif c != 0:
+                line += "  vs 0: too few nodes"
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Image size report per role from GNU ld map files.
+
+Reads the linker map files of a low power node build and of a lighting (friend) build and
+prints the flash and RAM taken by each module, an application object file or a library, in
+both images and the difference.  Code, read only data and initialized data count as flash,
+initialized data, zero initialized data and COMMON count as RAM.
+
+    python3 image_size.py --lpn lpn.map --friend friend.map
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+# Input section line: name, address, size, file.  Long names put address, size and file on
+# the next line.
+SECTION_RE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+NAME_ONLY_RE = re.compile(r"^ (\S+)$")
+CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+ARCHIVE_RE = re.compile(r"^(.*?)([^/\\]+\.a)\((.+)\)$")
+
+
+def module_name(path, by_object):
+    """libfoo.a for archive members (libfoo.a(bar.o) with by_object), object basename otherwise."""
+    m = ARCHIVE_RE.match(path.strip())
+    if m:
+        return "%s(%s)" % (m.group(2), m.group(3)) if by_object else m.group(2)
+    return os.path.basename(path.strip())
+
+
+def kind(section):
+    """Returns (flash, ram) weights of an input section."""
+    if section == "COMMON" or ".bss" in section or ".noinit" in section or section.startswith(".stack") or section.startswith(".heap"):
+        return 0, 1
+    if ".data" in section:
+        return 1, 1
+    if section.startswith(".debug") or section.startswith(".comment") or section.startswith(".ARM.attributes"):
+        return 0, 0
+    return 1, 0
+
+
+def parse_map(path, by_object):
+    """Returns {module: [flash, ram]} in bytes."""
+    sizes = defaultdict(lambda: [0, 0])
+    in_map = False
+    pending = None
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+            if line.startswith("/DISCARD/") or line.startswith("OUTPUT("):
+                break
+            if pending is not None:
+                m = CONT_RE.match(line)
+                section, pending = pending, None
+                if m:
+                    add(sizes, section, int(m.group(2), 16), m.group(3), by_object)
+                    continue
+            m = SECTION_RE.match(line)
+            if m:
+                add(sizes, m.group(1), int(m.group(3), 16), m.group(4), by_object)
+                continue
+            m = NAME_ONLY_RE.match(line)
+            if m:
+                pending = m.group(1)
+    if not in_map:
+        sys.exit("%s: no memory map, link with -Wl,-Map" % path)
+    return sizes
+
+
+def add(sizes, section, size, path, by_object):
+    if size == 0 or path.startswith("load address") or path.startswith("*"):
+        return
+    flash, ram = kind(section)
+    entry = sizes[module_name(path, by_object)]
+    entry[0] += flash * size
+    entry[1] += ram * size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--lpn", required=True, help="map file of the LOW_POWER_NODE=1 build")
+    parser.add_argument("--friend", required=True, help="map file of the LOW_POWER_NODE=0 build")
+    parser.add_argument("--by-object", action="store_true", help="report library members separately")
+    parser.add_argument("--top", type=int, default=0, help="print only the modules with the largest images, 0 for all")
+    args = parser.parse_args()
+
+    lpn = parse_map(args.lpn, args.by_object)
+    friend = parse_map(args.friend, args.by_object)
+    modules = sorted(set(lpn) | set(friend), key=lambda m: -max(sum(lpn.get(m, [0, 0])), sum(friend.get(m, [0, 0]))))
+    if args.top:
+        modules = modules[:args.top]
+
+    print("%-40s %9s %9s %9s %9s %9s %9s" % ("module", "lpn flash", "lpn ram", "fr flash", "fr ram", "d flash", "d ram"))
+    for m in modules:
+        lf, lr = lpn.get(m, [0, 0])
+        ff, fr = friend.get(m, [0, 0])
+        print("%-40s %9d %9d %9d %9d %+9d %+9d" % (m[:40], lf, lr, ff, fr, lf - ff, lr - fr))
+    lf = sum(v[0] for v in lpn.values())
+    lr = sum(v[1] for v in lpn.values())
+    ff = sum(v[0] for v in friend.values())
+    fr = sum(v[1] for v in friend.values())
+    print("%-40s %9d %9d %9d %9d %+9d %+9d" % ("total", lf, lr, ff, fr, lf - ff, lr - fr))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+Adaptive network transmit and relay retransmit counts.
+
+Lighting nodes are placed on grids of different density and on a corridor.  Nodes use
+static retransmit counts, or with ADAPTIVE_TX each node starts at the maximum count and
+steps it between the bounds from the copies of each new PDU it hears in its network
+message cache.  Reports delivery ratio, average retransmit count and air time per
+published message after the counts have settled.
+
+    python3 adaptive_tx.py --rate 2 --duration 240 --warmup 180
+"""
+
+import argparse
+import functools
+import random
+
+from mesh_sim.mesh import RangeMedium, NodeConfig, MeshNode, AdaptiveNode, grid
+from mesh_sim.sim import Simulator
+
+# name, columns, rows, spacing in m
+TOPOLOGIES = (
+    ("dense", 6, 6, 3.0),
+    ("office", 6, 6, 6.0),
+    ("sparse", 6, 6, 10.0),
+    ("corridor", 12, 1, 8.0),
+)
+
+
+def run(topology, cls, count, args):
+    name, cols, rows, spacing = topology
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = RangeMedium(sim, args.range)
+    cfg = NodeConfig(network_transmit_count=count, relay_retransmit_count=count)
+    nodes = grid(sim, medium, cols, rows, spacing, cfg, cls=cls, jitter_m=spacing / 4)
+    published = []
+    counted = {"airtime_us": 0}
+
+    def publish():
+        pdu = rng.choice(nodes).publish()
+        if args.warmup * 1e6 <= sim.now < (args.duration - 2) * 1e6:
+            published.append(pdu)
+        sim.after(int(rng.expovariate(args.rate) * 1e6), publish)
+
+    def warmup_done():
+        counted["airtime_us"] = medium.airtime_us
+
+    sim.after(0, publish)
+    sim.at(int(args.warmup * 1e6), warmup_done)
+    sim.run(int(args.duration * 1e6))
+
+    airtime_us = medium.airtime_us - counted["airtime_us"]
+    reach = 0
+    for src, seq, _ in published:
+        reach += sum(1 for n in nodes if n.addr == src or (src, seq) in n.stats.delivered)
+    count = max(len(published), 1)
+    neighbours = sum(len(n.neighbours) for n in nodes) / len(nodes)
+    retransmit = sum(n.cfg.relay_retransmit_count for n in nodes) / len(nodes)
+    return neighbours, reach / (count * len(nodes)), retransmit, airtime_us / count / 1000.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--range", type=float, default=13.0, help="radio range in m")
+    parser.add_argument("--rate", type=float, default=2.0, help="messages published per second in the network")
+    parser.add_argument("--duration", type=float, default=240, help="simulated time in seconds")
+    parser.add_argument("--warmup", type=float, default=180, help="seconds before the measurement starts")
+    parser.add_argument("--min", type=int, default=1, help="ADAPTIVE_TX_MIN, lowest retransmit count")
+    parser.add_argument("--max", type=int, default=4, help="ADAPTIVE_TX_MAX, highest retransmit count")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    adaptive = functools.partial(AdaptiveNode, min_count=args.min, max_count=args.max)
+    print("%-9s %10s %-9s %9s %11s %12s" % ("topology", "neighbours", "count", "delivery", "retransmit", "air time ms"))
+    for topology in TOPOLOGIES:
+        for label, cls, count in (("static %d" % args.min, MeshNode, args.min),
+                                  ("static %d" % args.max, MeshNode, args.max),
+                                  ("adaptive", adaptive, args.max)):
+            neighbours, delivery, retransmit, airtime_ms = run(topology, cls, count, args)
+            print("%-9s %10.1f %-9s %9.3f %11.2f %12.1f" % (topology[0], neighbours, label, delivery, retransmit, airtime_ms))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Friend Cache overflow policy under burst load.
+
+Several controllers send state updates (for example Generic OnOff Set) to one LPN.  When
+a burst arrives while the LPN sleeps, the Friend Cache overflows and the friend discards
+messages according to FRIEND_CACHE_POLICY.  The scenario compares the policies and
+reports lost messages and how often the LPN ends a burst with a stale state, i.e. the
+last delivered message from a controller is not the last one that controller sent.
+
+    python3 cache_policy.py --controllers 4 --burst 12 --cache-buf-len 300
+"""
+
+import argparse
+import random
+
+from mesh_sim.config import LowPowerConfig, FriendConfig
+from mesh_sim.friendship import CACHE_POLICIES, ACCESS_PDU_LEN, Lpn, Friend, Background
+from mesh_sim.radio import Medium
+from mesh_sim.sim import Simulator
+
+LPN_ADDR = 0x0010
+GROUP_ADDR = 0xc000
+SEGMENT_PDU_LEN = 29            # lower transport PDU of one segment
+
+
+class Controllers:
+    """Bursts of state updates from a set of controllers to the LPN group address."""
+
+    def __init__(self, sim, friend, args):
+        self.sim = sim
+        self.friend = friend
+        self.args = args
+        self.seq = {}               # (src, dst) -> seq of the last message sent
+        self.sent = 0               # PDUs sent to the friend, segments counted separately
+        self.checks = 0
+        self.stale = 0
+        self.lpn = None
+        self._next()
+
+    def _next(self):
+        self.sim.after(int(self.sim.rng.expovariate(self.args.bursts_per_hour / 3600.0) * 1e6), self._burst)
+
+    def _burst(self):
+        spacing_us = int(self.args.burst_spacing * 1000)
+        for i in range(self.args.burst):
+            self.sim.after(i * spacing_us, self._message)
+        # Check the LPN state once the friend had time to deliver the whole cache
+        settle_us = self.args.burst * spacing_us + 4 * LowPowerConfig.poll_timeout * 100000
+        self.sim.after(settle_us, self._check)
+        self._next()
+
+    def _message(self):
+        src = 0x0100 + self.sim.rng.randrange(self.args.controllers)
+        if self.sim.rng.random() < self.args.segmented:
+            for _ in range(2):
+                self.sent += 1
+                self.friend.enqueue(LPN_ADDR, SEGMENT_PDU_LEN, src, GROUP_ADDR, 0, seg=True)
+            return
+        key = (src, GROUP_ADDR)
+        self.seq[key] = self.seq.get(key, 0) + 1
+        self.sent += 1
+        self.friend.enqueue(LPN_ADDR, ACCESS_PDU_LEN, src, GROUP_ADDR, self.seq[key])
+
+    def _check(self):
+        for key, seq in self.seq.items():
+            self.checks += 1
+            if self.lpn.state.get(key, 0) != seq:
+                self.stale += 1
+
+
+def run(cache_policy, args):
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = Medium(sim)
+    friend = Friend(sim, medium, FriendConfig(cache_buf_len=args.cache_buf_len), cache_policy=cache_policy)
+    Background(sim, medium, args.background)
+    controllers = Controllers(sim, friend, args)
+    controllers.lpn = Lpn(sim, medium, friend, LPN_ADDR, LowPowerConfig(), rng.randrange(LowPowerConfig.poll_timeout * 100000))
+    sim.run(int(args.duration * 1e6))
+    return controllers, controllers.lpn, friend
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--controllers", type=int, default=4, help="nodes sending state updates to the LPN")
+    parser.add_argument("--burst", type=int, default=12, help="messages per burst")
+    parser.add_argument("--burst-spacing", type=float, default=100.0, help="ms between messages of a burst")
+    parser.add_argument("--bursts-per-hour", type=float, default=30.0)
+    parser.add_argument("--segmented", type=float, default=0.1, help="fraction of messages sent as two segments")
+    parser.add_argument("--cache-buf-len", type=int, default=FriendConfig.cache_buf_len, help="bytes")
+    parser.add_argument("--background", type=float, default=2.0, help="other mesh traffic in range, PDUs per second")
+    parser.add_argument("--duration", type=float, default=36000, help="simulated time in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%-9s %8s %8s %9s %8s %8s %9s" % ("policy", "sent", "dropped", "overflow", "loss %", "checks", "stale %"))
+    for cache_policy in CACHE_POLICIES:
+        controllers, lpn, friend = run(cache_policy, args)
+        print("%-9s %8d %8d %9d %8.2f %8d %9.2f" % (cache_policy, controllers.sent, lpn.stats.dropped,
+                                                    friend.stats.cache_overflows,
+                                                    100.0 * lpn.stats.dropped / max(controllers.sent, 1),
+                                                    controllers.checks,
+                                                    100.0 * controllers.stale / max(controllers.checks, 1)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""
+LE Coded PHY on the LPN-friend link.
+
+LPNs are placed at different distances from their friend, given as the mean RSSI of the
+link.  Each runs with the 1M PHY, always with Coded PHY S8, or with CODED_PHY selecting
+the PHY from the first attempt success rate and the response RSSI.  Reports the share of
+poll cycles answered at the first attempt, retries per cycle, poll cycles which failed
+after all retries, the share of cycles on Coded PHY, the fallbacks to 1M and the LPN average
+current.  The fading makes single runs noisy, with --seeds N every figure is the mean of the
+runs with seeds --seed to --seed + N - 1.
+
+    python3 coded_phy.py --rssi=-80,-88,-92,-95,-98,-101 --duration 7200 --seeds 10
+"""
+
+import argparse
+import random
+
+from mesh_sim.config import LowPowerConfig, FriendConfig
+from mesh_sim.energy import EnergyModel
+from mesh_sim.friendship import Friend, Background
+from mesh_sim.phy import CodedLpn, POLICIES
+from mesh_sim.radio import Medium
+from mesh_sim.sim import Simulator
+
+
+def run(rssi, policy, args, seed):
+    rng = random.Random(seed)
+    sim = Simulator(rng)
+    medium = Medium(sim)
+    friend = Friend(sim, medium, FriendConfig())
+    Background(sim, medium, args.background)
+    low_power = LowPowerConfig()
+    lpn = CodedLpn(sim, medium, friend, 0x0010, low_power, rng.randrange(low_power.poll_timeout * 100000), rssi, policy)
+    duration_us = int(args.duration * 1e6)
+    sim.run(duration_us)
+
+    stats = lpn.stats
+    polls = max(stats.polls, 1)
+    current = EnergyModel().average_current_ua(stats, duration_us, 0)
+    return {
+        "first": 1.0 - lpn.first_failures / polls,
+        "retries": stats.retries / polls,
+        "failed": stats.failed_cycles,
+        "coded": lpn.coded_cycles / polls,
+        "fallbacks": lpn.fallbacks,
+        "current": current,
+    }
+
+
+def run_seeds(rssi, policy, args):
+    runs = [run(rssi, policy, args, args.seed + i) for i in range(args.seeds)]
+    return {key: sum(r[key] for r in runs) / len(runs) for key in runs[0]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--rssi", default="-80,-88,-92,-95,-98,-101", help="comma separated mean RSSI of the link in dBm")
+    parser.add_argument("--background", type=float, default=2.0, help="other mesh traffic in range, PDUs per second")
+    parser.add_argument("--duration", type=float, default=7200, help="simulated time in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--seeds", type=int, default=1, help="runs averaged, seeds --seed and up")
+    args = parser.parse_args()
+
+    print("%5s %-9s %8s %9s %7s %7s %9s %11s" % ("rssi", "phy", "first", "retries", "failed", "coded", "fallbacks",
+                                                  "current uA"))
+    for rssi in [float(r) for r in args.rssi.split(",")]:
+        for policy in POLICIES:
+            r = run_seeds(rssi, policy, args)
+            print("%5d %-9s %8.3f %9.2f %7.1f %7.2f %9.1f %11.2f" % (rssi, policy, r["first"], r["retries"], r["failed"],
+                                                                    r["coded"], r["fallbacks"], r["current"]))
+
+
+if __name__ == "__main__":
+    main()
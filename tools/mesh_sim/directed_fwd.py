@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Directed forwarding compared with managed flooding.
+
+Lighting nodes on a grid carry unicast flows, for example sensors publishing to a
+controller or the provisioner configuring the friend of a low power node.  With flooding
+every node relays every message.  With DIRECTED_FWD the origin of a flow discovers a path
+after a few messages and the later messages are relayed only by the forwarding nodes on
+the path.  Reports delivery ratio and latency at the destination, relay transmissions and
+air time per message (the path discovery is included), and the discoveries.
+
+    python3 directed_fwd.py --cols 10 --rows 10 --flows 8 --rate 0.5
+"""
+
+import argparse
+import random
+
+from mesh_sim.mesh import RangeMedium, NodeConfig, DirectedNode, grid
+from mesh_sim.sim import Simulator
+
+
+def run(directed, args):
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = RangeMedium(sim, args.range)
+    nodes = grid(sim, medium, args.cols, args.rows, args.spacing, NodeConfig(), cls=DirectedNode, jitter_m=args.spacing / 4)
+    for node in nodes:
+        node.directed = directed
+    by_addr = {node.addr: node for node in nodes}
+    flow_rng = random.Random(args.seed + 1)
+    flows = [tuple(flow_rng.sample(nodes, 2)) for _ in range(args.flows)]
+    sent = []
+    counted = {"relay_tx": 0, "airtime_us": 0}
+
+    def send(origin, target):
+        src, seq, *_ = origin.send_to(target.addr)
+        if args.warmup * 1e6 <= sim.now < (args.duration - 2) * 1e6:
+            sent.append((src, seq, target.addr, sim.now))
+        sim.after(int(rng.expovariate(args.rate) * 1e6), send, origin, target)
+
+    def warmup_done():
+        counted["relay_tx"] = sum(n.stats.relay_tx for n in nodes)
+        counted["airtime_us"] = medium.airtime_us
+
+    for origin, target in flows:
+        sim.after(int(rng.expovariate(args.rate) * 1e6), send, origin, target)
+    sim.at(int(args.warmup * 1e6), warmup_done)
+    sim.run(int(args.duration * 1e6))
+
+    latencies = []
+    for src, seq, dst, t in sent:
+        at = by_addr[dst].delivered_at.get((src, seq))
+        if at is not None:
+            latencies.append((at - t) / 1000.0)
+    latencies.sort()
+    count = max(len(sent), 1)
+    relay_tx = sum(n.stats.relay_tx for n in nodes) - counted["relay_tx"]
+    airtime_us = medium.airtime_us - counted["airtime_us"]
+    return {
+        "delivery": len(latencies) / count,
+        "latency": sum(latencies) / max(len(latencies), 1),
+        "p95": latencies[int(len(latencies) * 0.95)] if latencies else 0.0,
+        "relay_tx": relay_tx / count,
+        "airtime": airtime_us / count / 1000.0,
+        "discoveries": sum(n.discoveries for n in nodes),
+        "routes": sum(len(n.routes) for n in nodes),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--cols", type=int, default=10)
+    parser.add_argument("--rows", type=int, default=10)
+    parser.add_argument("--spacing", type=float, default=6.0, help="grid spacing in m")
+    parser.add_argument("--range", type=float, default=13.0, help="radio range in m")
+    parser.add_argument("--flows", type=int, default=8, help="unicast flows between random nodes")
+    parser.add_argument("--rate", type=float, default=0.5, help="messages per second of each flow")
+    parser.add_argument("--duration", type=float, default=120, help="simulated time in seconds")
+    parser.add_argument("--warmup", type=float, default=20, help="seconds before the measurement starts")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%-9s %9s %11s %9s %9s %12s %12s" % ("mode", "delivery", "latency ms", "p95 ms", "relay tx", "air time ms", "discoveries"))
+    for label, directed in (("flooding", False), ("directed", True)):
+        r = run(directed, args)
+        print("%-9s %9.3f %11.1f %9.1f %9.1f %12.1f %7d (%d)" % (label, r["delivery"], r["latency"], r["p95"], r["relay_tx"],
+                                                              r["airtime"], r["discoveries"], r["routes"]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+Extended advertising bearer compared with segmentation on the legacy bearer.
+
+Lighting nodes on a grid send access messages of one length to random destinations.  On
+the legacy bearer a message longer than an unsegmented message is split in segments of
+12 bytes sent one SAR segment interval apart, every segment is a network PDU relayed on
+its own.  With EXT_ADV_BEARER the message is sent and relayed as one long network PDU
+in an extended advertising event.  Reports network PDUs and air time per message, and
+the delivery ratio and latency of complete messages at the destination.  Segment
+acknowledgements and retransmissions are not modelled.
+
+    python3 ext_adv.py --sizes 8,20,40,80,160 --rate 2
+"""
+
+import argparse
+import random
+
+from mesh_sim.mesh import ExtAdvMedium, NodeConfig, ExtAdvNode, grid
+from mesh_sim.sim import Simulator
+
+
+def run(size, ext, args):
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = ExtAdvMedium(sim, args.range)
+    nodes = grid(sim, medium, args.cols, args.rows, args.spacing, NodeConfig(), cls=ExtAdvNode, jitter_m=args.spacing / 4)
+    for node in nodes:
+        node.ext = ext
+        node.sar_interval_ms = args.sar_interval
+    sent = []
+    counted = {"airtime_us": 0}
+
+    def send():
+        src, dst = rng.sample(nodes, 2)
+        keys = src.send_message(size)
+        if args.warmup * 1e6 <= sim.now < (args.duration - 3) * 1e6:
+            sent.append((keys, dst, sim.now))
+        sim.after(int(rng.expovariate(args.rate) * 1e6), send)
+
+    def warmup_done():
+        counted["airtime_us"] = medium.airtime_us
+
+    sim.after(0, send)
+    sim.at(int(args.warmup * 1e6), warmup_done)
+    sim.run(int(args.duration * 1e6))
+
+    latencies = []
+    pdus = 0
+    for keys, dst, t in sent:
+        pdus += len(keys)
+        times = [dst.delivered_at.get(key) for key in keys]
+        if all(times):
+            latencies.append((max(times) - t) / 1000.0)
+    latencies.sort()
+    count = max(len(sent), 1)
+    return {
+        "pdus": pdus / count,
+        "airtime": (medium.airtime_us - counted["airtime_us"]) / count / 1000.0,
+        "delivery": len(latencies) / count,
+        "latency": sum(latencies) / max(len(latencies), 1),
+        "p95": latencies[int(len(latencies) * 0.95)] if latencies else 0.0,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--cols", type=int, default=6)
+    parser.add_argument("--rows", type=int, default=6)
+    parser.add_argument("--spacing", type=float, default=6.0, help="grid spacing in m")
+    parser.add_argument("--range", type=float, default=13.0, help="radio range in m")
+    parser.add_argument("--sizes", default="8,20,40,80,160", help="comma separated access message lengths in bytes")
+    parser.add_argument("--rate", type=float, default=2.0, help="messages per second in the network")
+    parser.add_argument("--sar-interval", type=int, default=60, help="SAR segment interval in ms")
+    parser.add_argument("--duration", type=float, default=90, help="simulated time in seconds")
+    parser.add_argument("--warmup", type=float, default=5, help="seconds before the measurement starts")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%5s %-7s %8s %12s %9s %11s %9s" % ("bytes", "bearer", "pdus", "air time ms", "delivery", "latency ms", "p95 ms"))
+    for size in [int(s) for s in args.sizes.split(",")]:
+        for label, ext in (("legacy", False), ("ext", True)):
+            r = run(size, ext, args)
+            print("%5d %-7s %8.1f %12.1f %9.3f %11.1f %9.1f" % (size, label, r["pdus"], r["airtime"], r["delivery"],
+                                                              r["latency"], r["p95"]))
+
+
+if __name__ == "__main__":
+    main()
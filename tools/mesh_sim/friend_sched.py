@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""
+Friend transmit scheduling across LPNs.
+
+The friend answers each Poll inside the LPN receive window, while the same radio relays
+mesh traffic, sends proxy advertisements and serves a GATT proxy connection.  The
+scenario compares FIFO transmission with earliest-deadline-first scheduling and reports
+missed receive windows, LPN retries and the delay of the other traffic classes.
+
+    python3 friend_sched.py --lpns 8 --relay 20 --conn-interval 30
+
+With --classes the maximum queue depth and the mean and 95th percentile latency of each
+class are printed as well, the same figures TX_SCHED reports over WICED HCI.
+"""
+
+import argparse
+import random
+
+from mesh_sim.config import LowPowerConfig, FriendConfig, spread_poll
+from mesh_sim.friendship import Lpn, Friend, Background, LpnStats
+from mesh_sim.radio import Medium
+from mesh_sim.sim import Simulator
+from mesh_sim.txsched import POLICIES, ConnectionEvents, PeriodicTx, RelayTraffic
+
+PROXY_ADV_PDU_LEN = 20          # service data of the Mesh Proxy Service advertisement
+BEACON_PDU_LEN = 22             # secure network beacon
+
+
+def run(policy, args):
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = Medium(sim)
+    friend = Friend(sim, medium, FriendConfig(receive_window=args.receive_window, max_lpn_num=args.lpns), policy)
+    Background(sim, medium, args.background)
+    RelayTraffic(sim, friend.tx, args.relay)
+    ConnectionEvents(sim, friend.tx, args.conn_interval)
+    PeriodicTx(sim, friend.tx, "proxy_adv", args.proxy_adv_interval, PROXY_ADV_PDU_LEN, slack_ms=args.proxy_adv_interval / 2)
+    PeriodicTx(sim, friend.tx, "beacon", 10000, BEACON_PDU_LEN, slack_ms=1000)
+
+    base = LowPowerConfig()
+    lpns = []
+    for i in range(args.lpns):
+        addr = 0x0010 + i
+        lpns.append(Lpn(sim, medium, friend, addr, spread_poll(base, addr), rng.randrange(base.poll_timeout * 100000)))
+    sim.run(int(args.duration * 1e6))
+
+    total = LpnStats()
+    for lpn in lpns:
+        total.merge(lpn.stats)
+    return total, friend
+
+
+def p95_ms(values):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[int(0.95 * (len(values) - 1))] / 1000.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--lpns", type=int, default=8, help="LPNs served by the friend")
+    parser.add_argument("--relay", type=float, default=20.0, help="PDUs relayed by the friend per second")
+    parser.add_argument("--conn-interval", type=float, default=30.0, help="GATT proxy connection interval in ms, 0 if not connected")
+    parser.add_argument("--proxy-adv-interval", type=float, default=100.0, help="proxy advertisement interval in ms, 0 if disabled")
+    parser.add_argument("--receive-window", type=int, default=FriendConfig.receive_window, help="ms")
+    parser.add_argument("--background", type=float, default=2.0, help="other mesh traffic in range, PDUs per second")
+    parser.add_argument("--duration", type=float, default=3600, help="simulated time in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--classes", action="store_true", help="print queue depth and latency per class")
+    args = parser.parse_args()
+
+    print("%-6s %8s %8s %8s %10s %14s %14s" % ("policy", "polls", "missed", "retries", "retry/100",
+                                               "relay p95 ms", "relay missed"))
+    friends = []
+    for policy in POLICIES:
+        lpn, friend = run(policy, args)
+        friends.append((policy, friend))
+        relay = friend.tx.stats.get("relay")
+        print("%-6s %8d %8d %8d %10.2f %14.2f %14d" % (policy, lpn.polls, friend.stats.missed_windows, lpn.retries,
+                                                       100.0 * lpn.retries / max(lpn.polls, 1),
+                                                       p95_ms(relay.delay_us) if relay else 0.0,
+                                                       relay.missed if relay else 0))
+
+    if args.classes:
+        print()
+        print("%-6s %-10s %9s %8s %8s %12s %12s" % ("policy", "class", "max depth", "sent", "missed", "mean ms", "p95 ms"))
+        for policy, friend in friends:
+            for kind in sorted(friend.tx.stats):
+                stats = friend.tx.stats[kind]
+                mean = sum(stats.delay_us) / len(stats.delay_us) / 1000.0 if stats.delay_us else 0.0
+                print("%-6s %-10s %9d %8d %8d %12.2f %12.2f" % (policy, kind, friend.tx.depth_max, stats.sent, stats.missed,
+                                                             mean, p95_ms(stats.delay_us)))
+
+
+if __name__ == "__main__":
+    main()
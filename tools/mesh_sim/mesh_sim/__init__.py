@@ -0,0 +1,8 @@
+"""
+Discrete event simulator of the Low Power LED mesh application.
+
+The simulator models the parts of the LE Mesh stack which determine the
+energy and latency of the low_power_led application: the advertising bearer,
+the Low Power Node poll cycle and the Friend node.  Parameter defaults mirror
+mesh_config in low_power_led.c.
+"""
@@ -0,0 +1,35 @@
+"""
+Friendship parameters.  Defaults are the values used in mesh_config in low_power_led.c.
+"""
+
+from dataclasses import dataclass
+
+
+@dataclass
+class LowPowerConfig:
+    rssi_factor: int = 2                # contribution of the RSSI to the Friend Offer Delay
+    receive_window_factor: int = 2      # contribution of the Receive Window to the Friend Offer Delay
+    min_cache_size_log: int = 3         # minimum Friend Cache size requested, log2 of the number of messages
+    receive_delay: int = 100            # ms
+    poll_timeout: int = 200             # 100 ms units
+
+
+@dataclass
+class FriendConfig:
+    receive_window: int = 20            # ms
+    cache_buf_len: int = 300            # bytes
+    max_lpn_num: int = 4
+
+
+# LPN_POLL_SPREAD parameters, see mesh_low_power_led_spread_poll() in low_power_led.c
+LPN_POLL_SPREAD_SLOTS = 8
+LPN_POLL_SPREAD_RECEIVE_DELAY_STEP = 10
+LPN_POLL_SPREAD_POLL_TIMEOUT_STEP = 1
+
+
+def spread_poll(low_power, unicast_addr):
+    """Returns copy of the low_power configuration as adjusted by LPN_POLL_SPREAD on the node."""
+    slot = unicast_addr % LPN_POLL_SPREAD_SLOTS
+    return LowPowerConfig(low_power.rssi_factor, low_power.receive_window_factor, low_power.min_cache_size_log,
+                          low_power.receive_delay + slot * LPN_POLL_SPREAD_RECEIVE_DELAY_STEP,
+                          low_power.poll_timeout + slot * LPN_POLL_SPREAD_POLL_TIMEOUT_STEP)
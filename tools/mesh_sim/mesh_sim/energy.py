@@ -0,0 +1,30 @@
+"""
+LPN energy model.  Currents are typical values for CYW20819 at 3 V and can be replaced
+with values measured on the target board.
+"""
+
+from dataclasses import dataclass
+
+
+@dataclass
+class EnergyModel:
+    sleep_ua: float = 10.0          # ePDS with the LED GPIO state maintained
+    active_ua: float = 1500.0       # CPU running, radio idle
+    rx_ua: float = 5900.0           # receiving
+    tx_ua: float = 5600.0           # transmitting at 0 dBm
+    wake_us: int = 3000             # ePDS exit and entry, CPU active
+    voltage: float = 3.0
+    battery_mah: float = 225.0      # CR2032
+
+    def average_current_ua(self, stats, duration_us, adv_event_us):
+        """Average current of the LPN from LpnStats collected over duration_us."""
+        tx_us = stats.tx_us if stats.tx_us else stats.tx_events * adv_event_us
+        wake_us = stats.poll_tx * self.wake_us
+        active_us = max(stats.awake_us - stats.rx_us, 0) + wake_us
+        busy_us = tx_us + stats.rx_us + active_us
+        charge = (tx_us * self.tx_ua + stats.rx_us * self.rx_ua + active_us * self.active_ua
+                  + max(duration_us - busy_us, 0) * self.sleep_ua)
+        return charge / duration_us
+
+    def battery_days(self, average_ua):
+        return self.battery_mah * 1000.0 / average_ua / 24.0
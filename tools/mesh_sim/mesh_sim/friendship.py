@@ -0,0 +1,287 @@
+"""
+Low Power Node poll cycle and the Friend node serving it.
+
+The LPN sends a Poll, sleeps for ReceiveDelay and scans for ReceiveWindow.  If no
+response arrives in the window the Poll is retried.  The Friend answers each Poll with
+a cached message or with a Friend Update.  The Friend radio sends one advertising event
+at a time, so responses for different LPNs are serialized; a response which cannot start
+inside the LPN receive window is a missed window.
+"""
+
+from collections import deque
+
+from .radio import adv_airtime_us
+from .txsched import TxScheduler
+
+POLL_PDU_LEN = 19               # network header, Poll opcode and FSN, 64-bit NetMIC
+UPDATE_PDU_LEN = 24             # Friend Update
+ACCESS_PDU_LEN = 29             # unsegmented access message, for example Generic OnOff Set
+POLL_PERIOD_RATIO = 0.8         # LPN polls at this fraction of the poll timeout
+POLL_RETRY_MAX = 6              # friendship is considered lost after that many retries
+FRIEND_PROCESSING_US = 500      # friend time to prepare the response after the Poll is received
+RX_GUARD_US = 3 * (adv_airtime_us(ACCESS_PDU_LEN) + 150)   # LPN keeps receiving the event started in the window
+CACHE_ENTRY_OVERHEAD = 8        # bytes used by the friend cache for each stored message
+FACTOR_VALUES = (1.0, 1.5, 2.0, 2.5)    # RSSIFactor and ReceiveWindowFactor field encoding
+CACHE_POLICIES = ("oldest", "newest", "priority")   # FRIEND_CACHE_POLICY in the makefile
+
+
+class CacheEntry:
+    """Message stored in the friend cache.  Messages from src to dst carry the state, seq
+    increases with every new state.  Segments of segmented messages have seg set."""
+    __slots__ = ("queued_us", "pdu_len", "src", "dst", "seq", "seg")
+
+    def __init__(self, queued_us, pdu_len, src=0, dst=0, seq=0, seg=False):
+        self.queued_us = queued_us
+        self.pdu_len = pdu_len
+        self.src = src
+        self.dst = dst
+        self.seq = seq
+        self.seg = seg
+
+    def supersedes(self, older):
+        return not self.seg and not older.seg and self.src == older.src and self.dst == older.dst
+
+
+def friend_offer_delay_ms(low_power, receive_window, rssi):
+    """Friend Offer Delay calculated by a friend candidate from the Friend Request criteria."""
+    local_delay = (FACTOR_VALUES[low_power.receive_window_factor] * receive_window
+                   - FACTOR_VALUES[low_power.rssi_factor] * rssi)
+    return max(100.0, local_delay)
+
+
+def cache_capacity(friend_cfg, pdu_len=ACCESS_PDU_LEN):
+    """Number of messages the friend can store for one LPN."""
+    return friend_cfg.cache_buf_len // (pdu_len + CACHE_ENTRY_OVERHEAD)
+
+
+def select_friend(low_power, friend_cfg, candidates):
+    """Returns the candidate which sends the first Friend Offer, or None.  A candidate offers
+    friendship only if its cache can hold 2^min_cache_size_log messages."""
+    best = None
+    for candidate in candidates:
+        window = candidate.get("receive_window", friend_cfg.receive_window)
+        if cache_capacity(friend_cfg) < (1 << low_power.min_cache_size_log):
+            continue
+        delay = friend_offer_delay_ms(low_power, window, candidate["rssi"])
+        if best is None or delay < best[0]:
+            best = (delay, dict(candidate, receive_window=window))
+    return best[1] if best else None
+
+
+class LpnStats:
+    def __init__(self):
+        self.polls = 0              # poll cycles, not counting retries
+        self.poll_tx = 0            # Poll PDUs sent, including retries
+        self.retries = 0
+        self.polls_lost = 0         # Poll not received by the friend
+        self.responses_lost = 0     # response sent but not received
+        self.missed_windows = 0     # friend could not start the response inside the window
+        self.failed_cycles = 0      # poll cycle gave up after POLL_RETRY_MAX retries
+        self.awake_us = 0
+        self.rx_us = 0
+        self.idle_polls = 0         # first response was a Friend Update without more data
+        self.idle_awake_us = 0      # awake time of the idle polls, from the Poll to sleep
+        self.tx_events = 0
+        self.tx_us = 0              # transmit time of the Polls
+        self.delivered = 0
+        self.dropped = 0            # messages dropped from the friend cache
+        self.latency_us = []
+
+    def merge(self, other):
+        for name, value in vars(other).items():
+            if isinstance(value, list):
+                getattr(self, name).extend(value)
+            else:
+                setattr(self, name, getattr(self, name) + value)
+
+
+class Lpn:
+    us_per_byte = 8                 # LE 1M PHY, see mesh_sim/phy.py for LE Coded
+
+    def __init__(self, sim, medium, friend, addr, low_power, first_poll_us, poll_period_ratio=POLL_PERIOD_RATIO,
+                 link_per=0.0, early_sleep=True):
+        self.sim = sim
+        self.early_sleep = early_sleep      # LPN_EARLY_SLEEP, sleep on response without more data
+        self.link_per = link_per
+        self.medium = medium
+        self.friend = friend
+        self.addr = addr
+        self.low_power = low_power
+        self.poll_period_us = int(low_power.poll_timeout * 100000 * poll_period_ratio)
+        self.stats = LpnStats()
+        self._attempt = 0
+        self._cycle_start = 0
+        self._got_response = False
+        self._first_response = False
+        self.state = {}             # (src, dst) -> seq of the last delivered message
+        friend.add_lpn(self)
+        sim.at(first_poll_us, self._poll_cycle)
+
+    def _poll_cycle(self):
+        self.stats.polls += 1
+        self._attempt = 0
+        self._cycle_start = self.sim.now
+        self._first_response = True
+        self._send_poll()
+
+    def _send_poll(self):
+        self.stats.poll_tx += 1
+        self.stats.tx_events += 1
+        self._got_response = False
+        event = self.medium.send(self, POLL_PDU_LEN, self.us_per_byte)
+        poll_end = self.medium.event_end(event)
+        self.stats.tx_us += poll_end - self.sim.now
+        window_start = poll_end + self.low_power.receive_delay * 1000
+        window_end = window_start + self.friend.friend_cfg.receive_window * 1000
+        self.sim.at(poll_end, self.friend.poll_received, self, event, window_start, window_end)
+        self.sim.at(window_end + RX_GUARD_US * self.us_per_byte // 8, self._window_closed, window_start, window_end)
+
+    def response(self, event, window_start, window_end, more_data, entry):
+        """Called by the friend at the end of the response event.  Returns True if received."""
+        if self._got_response or not self.link_received(event, self, window_start):
+            self.stats.responses_lost += 1
+            return False
+        self._got_response = True
+        if entry is not None:
+            self.stats.delivered += 1
+            self.stats.latency_us.append(self.sim.now - entry.queued_us)
+            self.state[(entry.src, entry.dst)] = entry.seq
+        # Without early sleep the LPN keeps scanning until the end of the receive window
+        end_us = self.sim.now if self.early_sleep or more_data else max(self.sim.now, window_end)
+        self._account_awake(end_us, window_start)
+        if entry is None and not more_data and self._attempt == 0 and self._first_response:
+            self.stats.idle_polls += 1
+            self.stats.idle_awake_us += end_us - self._cycle_start
+        self._first_response = False
+        if more_data:
+            self._attempt = 0
+            self.sim.after(1000, self._send_poll)
+        else:
+            self._schedule_next_cycle()
+        return True
+
+    def link_received(self, event, receiver, scan_phase_us=0):
+        """Reception on the LPN-friend link, collisions and the link packet error rate."""
+        return self.medium.received(receiver, event, scan_phase_us) and self.sim.rng.random() >= self.link_per
+
+    def _window_closed(self, window_start, window_end):
+        if self._got_response:
+            return
+        self._account_awake(self.sim.now, window_start)
+        self._attempt += 1
+        if self._attempt > POLL_RETRY_MAX:
+            self.stats.failed_cycles += 1
+            self._schedule_next_cycle()
+            return
+        self.stats.retries += 1
+        self._send_poll()
+
+    def _account_awake(self, end_us, window_start):
+        # The radio sleeps during the receive delay, the CPU is awake from the Poll to the end of reception
+        self.stats.rx_us += end_us - window_start
+        self.stats.awake_us += end_us - window_start
+
+    def _schedule_next_cycle(self):
+        self.sim.at(self._cycle_start + self.poll_period_us, self._poll_cycle)
+
+
+class FriendStats:
+    def __init__(self):
+        self.polls_received = 0
+        self.responses = 0
+        self.missed_windows = 0
+        self.cache_overflows = 0
+
+
+class Friend:
+    def __init__(self, sim, medium, friend_cfg, policy="fifo", cache_policy="oldest"):
+        if cache_policy not in CACHE_POLICIES:
+            raise ValueError("unknown cache policy %s" % cache_policy)
+        self.sim = sim
+        self.medium = medium
+        self.friend_cfg = friend_cfg
+        self.cache_policy = cache_policy
+        self.stats = FriendStats()
+        self.lpns = {}
+        self.cache = {}
+        self.tx = TxScheduler(sim, medium, self, policy)
+
+    def add_lpn(self, lpn):
+        self.lpns[lpn.addr] = lpn
+        self.cache[lpn.addr] = deque()
+
+    def enqueue(self, lpn_addr, pdu_len=ACCESS_PDU_LEN, src=0, dst=0, seq=0, seg=False):
+        """Message for the LPN arrives to the friend and is stored in the Friend Cache.
+        When the cache is full a message is discarded according to the cache policy,
+        see friend_cache_policy.c."""
+        cache = self.cache[lpn_addr]
+        new = CacheEntry(self.sim.now, pdu_len, src, dst, seq, seg)
+        used = sum(entry.pdu_len + CACHE_ENTRY_OVERHEAD for entry in cache)
+        needed = pdu_len + CACHE_ENTRY_OVERHEAD
+        if used + needed > self.friend_cfg.cache_buf_len:
+            self.stats.cache_overflows += 1
+        while cache and used + needed > self.friend_cfg.cache_buf_len:
+            if self.cache_policy == "newest":
+                self.lpns[lpn_addr].stats.dropped += 1
+                return
+            victim = cache[0]
+            if self.cache_policy == "priority":
+                entries = list(cache) + [new]
+                for i, entry in enumerate(entries[:-1]):
+                    if any(newer.supersedes(entry) for newer in entries[i + 1:]):
+                        victim = entry
+                        break
+            cache.remove(victim)
+            used -= victim.pdu_len + CACHE_ENTRY_OVERHEAD
+            self.lpns[lpn_addr].stats.dropped += 1
+        cache.append(new)
+
+    def poll_received(self, lpn, event, window_start, window_end):
+        if not lpn.link_received(event, self):
+            lpn.stats.polls_lost += 1
+            return
+        self.stats.polls_received += 1
+        self.schedule_response(lpn, window_start, window_end)
+
+    def schedule_response(self, lpn, window_start, window_end):
+        """The response has to start inside the LPN receive window."""
+        cache = self.cache[lpn.addr]
+        entry = cache[0] if cache else None
+        pdu_len = entry.pdu_len if entry else UPDATE_PDU_LEN
+        # The response uses the PHY the Poll was received on
+        us_per_byte = lpn.us_per_byte
+        self.tx.submit("friend", pdu_len, window_start + FRIEND_PROCESSING_US, window_end - adv_airtime_us(pdu_len, us_per_byte),
+                       on_sent=lambda event: self._response_sent(lpn, event, window_start, window_end, entry),
+                       on_missed=lambda: self._missed_window(lpn), us_per_byte=us_per_byte)
+
+    def _missed_window(self, lpn):
+        self.stats.missed_windows += 1
+        lpn.stats.missed_windows += 1
+
+    def _response_sent(self, lpn, event, window_start, window_end, entry):
+        self.stats.responses += 1
+        cache = self.cache[lpn.addr]
+        if entry is not None and entry not in cache:
+            entry = None        # evicted while being sent, the LPN gets a stale copy only
+        more_data = len(cache) > 1 if entry else bool(cache)
+        if lpn.response(event, window_start, window_end, more_data, entry) and entry is not None:
+            cache.remove(entry)
+
+
+class Background:
+    """Relay and publication traffic from other nodes in range, Poisson arrivals."""
+
+    def __init__(self, sim, medium, rate_per_s, pdu_len=ACCESS_PDU_LEN):
+        self.sim = sim
+        self.medium = medium
+        self.rate_per_s = rate_per_s
+        self.pdu_len = pdu_len
+        if rate_per_s > 0:
+            self._next()
+
+    def _next(self):
+        self.sim.after(int(self.sim.rng.expovariate(self.rate_per_s) * 1e6), self._send)
+
+    def _send(self):
+        self.medium.send(self, self.pdu_len)
+        self._next()
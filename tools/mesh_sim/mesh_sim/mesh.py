@@ -0,0 +1,473 @@
+"""
+Multi-hop mesh of relay nodes on a floor plan.
+
+Nodes hear each other within range_m.  A node receives an advertising event if the copy
+on the channel it scans does not overlap with another transmission from a node in its
+range, and it is not transmitting itself.  Every node keeps a network message cache
+(NET_CACHE in the makefile) and relays new network PDUs with TTL >= 2 after a random
+delay, sending network_transmit / relay_retransmit copies like the mesh core.
+"""
+
+import copy
+import math
+
+from .radio import Medium, Transmission, ADV_CHANNELS, SCAN_WINDOW_US, adv_airtime_us, ADV_CHANNEL_SWITCH_US
+
+NET_PDU_LEN = 29                # unsegmented access message
+RELAY_DELAY_MAX_US = 10000      # random delay before the first relayed copy
+TX_HISTORY_US = 5000            # transmissions are kept for collision checks after they end
+DEFAULT_TTL = 7
+
+
+class RangeMedium(Medium):
+    """Advertising bearer where only nodes within range hear each other."""
+
+    def __init__(self, sim, range_m):
+        super().__init__(sim)
+        self.range_m = range_m
+        self.nodes = []
+        self._by_channel = {channel: [] for channel in ADV_CHANNELS}
+        self.airtime_us = 0         # sum of advertising event durations
+
+    def add(self, node):
+        self.nodes.append(node)
+        node.neighbours = []
+        node.neighbours_set = set()
+        for other in self.nodes[:-1]:
+            if math.dist(node.pos, other.pos) <= self.range_m:
+                node.neighbours.append(other)
+                node.neighbours_set.add(other)
+                other.neighbours.append(node)
+                other.neighbours_set.add(node)
+
+    def send(self, sender, network_pdu_len, us_per_byte=8, channels=ADV_CHANNELS):
+        """Same as Medium.send, transmissions are indexed per channel for the collision checks."""
+        airtime = adv_airtime_us(network_pdu_len, us_per_byte)
+        start = self.sim.now
+        event = []
+        for channel in channels:
+            tx = Transmission(sender, channel, start, start + airtime)
+            txs = self._by_channel[channel]
+            if len(txs) > 64 and txs[0].end < self.sim.now - TX_HISTORY_US:
+                txs[:] = [t for t in txs if t.end >= self.sim.now - TX_HISTORY_US]
+            txs.append(tx)
+            event.append(tx)
+            start += airtime + ADV_CHANNEL_SWITCH_US
+        self.transmissions += 1
+        self.airtime_us += start - self.sim.now
+        sender.tx_start = self.sim.now
+        sender.tx_until = start
+        return event
+
+    def broadcast(self, sender, pdu):
+        event = self.send(sender, NET_PDU_LEN)
+        self.sim.at(self.event_end(event), self._deliver, sender, event, pdu)
+        return event
+
+    def _deliver(self, sender, event, pdu):
+        for node in sender.neighbours:
+            if self.received(node, event, node.scan_phase_us):
+                node.receive(pdu)
+
+    def _collided(self, tx, receiver):
+        # Half duplex, the receiver sends one advertising event at a time
+        if receiver is not None and receiver.tx_until > tx.start and receiver.tx_start < tx.end:
+            return True
+        for other in reversed(self._by_channel[tx.channel]):
+            if other.end < tx.start - TX_HISTORY_US:
+                break
+            if other is tx or other.end <= tx.start or other.start >= tx.end:
+                continue
+            if receiver is None or other.sender in receiver.neighbours_set:
+                return True
+        return False
+
+
+class NetCache:
+    """Set associative network message cache of net_cache.c.  Each bucket holds WAYS
+    entries and replaces them round robin."""
+
+    WAYS = 4
+
+    def __init__(self, size):
+        self.ways = min(self.WAYS, size)
+        self.buckets = max(size // self.ways, 1)
+        self.entries = [[None] * self.ways for _ in range(self.buckets)]
+        self.next_way = [0] * self.buckets
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+
+    def check(self, src, seq):
+        """Returns True if the PDU was seen, otherwise adds it."""
+        bucket = ((src * 40503) ^ (seq * 2654435761)) % self.buckets
+        entries = self.entries[bucket]
+        if (src, seq) in entries:
+            self.hits += 1
+            return True
+        self.misses += 1
+        way = self.next_way[bucket]
+        if entries[way] is not None:
+            self.evictions += 1
+        entries[way] = (src, seq)
+        self.next_way[bucket] = (way + 1) % self.ways
+        return False
+
+
+class NodeConfig:
+    def __init__(self, net_cache_size=64, network_transmit_count=2, network_transmit_interval_ms=20,
+                 relay=True, relay_retransmit_count=2, relay_retransmit_interval_ms=20):
+        self.net_cache_size = net_cache_size
+        self.network_transmit_count = network_transmit_count
+        self.network_transmit_interval_ms = network_transmit_interval_ms
+        self.relay = relay
+        self.relay_retransmit_count = relay_retransmit_count
+        self.relay_retransmit_interval_ms = relay_retransmit_interval_ms
+
+
+class NodeStats:
+    def __init__(self):
+        self.published = 0
+        self.relayed = 0            # relay decisions, each sends relay_retransmit_count + 1 copies
+        self.relay_tx = 0           # advertising events of relayed PDUs
+        self.leaked = 0             # PDU relayed again after it was evicted from the cache
+        self.received = 0
+        self.delivered = set()      # (src, seq) received for the first time
+
+
+class MeshNode:
+    def __init__(self, sim, medium, addr, pos, cfg):
+        self.sim = sim
+        self.medium = medium
+        self.addr = addr
+        self.pos = pos
+        self.cfg = cfg
+        self.cache = NetCache(cfg.net_cache_size)
+        self.stats = NodeStats()
+        self.scan_phase_us = sim.rng.randrange(SCAN_WINDOW_US * len(ADV_CHANNELS))
+        self._seq = 0
+        self._busy_until = 0
+        self._relayed = set()
+        self.tx_start = 0
+        self.tx_until = 0
+        medium.add(self)
+
+    def publish(self, ttl=DEFAULT_TTL):
+        self._seq += 1
+        pdu = (self.addr, self._seq, ttl)
+        self.cache.check(self.addr, self._seq)
+        self.stats.published += 1
+        self._transmit(pdu, self.cfg.network_transmit_count, self.cfg.network_transmit_interval_ms, 0)
+        return pdu
+
+    def receive(self, pdu):
+        src, seq, ttl = pdu
+        self.stats.received += 1
+        if self.cache.check(src, seq):
+            return
+        self.stats.delivered.add((src, seq))
+        if self.cfg.relay and ttl >= 2 and self.should_relay(pdu):
+            if (src, seq) in self._relayed:
+                self.stats.leaked += 1
+            self._relayed.add((src, seq))
+            self.stats.relayed += 1
+            self._transmit((src, seq, ttl - 1), self.cfg.relay_retransmit_count,
+                           self.cfg.relay_retransmit_interval_ms, self.sim.rng.randrange(RELAY_DELAY_MAX_US), relay=True)
+
+    def should_relay(self, pdu):
+        return True
+
+    def _transmit(self, pdu, retransmit_count, interval_ms, delay_us, relay=False):
+        airtime = len(ADV_CHANNELS) * (adv_airtime_us(NET_PDU_LEN) + ADV_CHANNEL_SWITCH_US)
+        start = max(self.sim.now + delay_us, self._busy_until)
+        for i in range(retransmit_count + 1):
+            # Advertising delay of 0 to 10 ms is added to every advertising event
+            t = start + i * interval_ms * 1000 + self.sim.rng.randrange(10000)
+            t = max(t, self._busy_until)
+            self._busy_until = t + airtime
+            self.sim.at(t, self._send, pdu, relay)
+
+    def _send(self, pdu, relay):
+        if relay:
+            self.stats.relay_tx += 1
+        self.medium.broadcast(self, pdu)
+
+
+def grid(sim, medium, cols, rows, spacing_m, cfg, cls=MeshNode, jitter_m=0.0):
+    """Nodes on a grid, addresses from 0x0100.  Returns list of nodes."""
+    nodes = []
+    for r in range(rows):
+        for c in range(cols):
+            pos = (c * spacing_m + sim.rng.uniform(-jitter_m, jitter_m), r * spacing_m + sim.rng.uniform(-jitter_m, jitter_m))
+            nodes.append(cls(sim, medium, 0x0100 + len(nodes), pos, cfg))
+    return nodes
+
+
+# RELAY_PRUNE parameters, see relay_prune.c
+RELAY_PRUNE_INTERVAL_S = 30
+RELAY_PRUNE_MIN_SAMPLES = 20
+RELAY_PRUNE_COVERAGE = 4
+RELAY_PRUNE_MIN_PROBABILITY = 64
+RELAY_PRUNE_ALWAYS = 256
+
+
+class PruningNode(MeshNode):
+    """Node with RELAY_PRUNE: relay probability from the duplicates in the network cache."""
+
+    def __init__(self, sim, medium, addr, pos, cfg, interval_s=RELAY_PRUNE_INTERVAL_S):
+        super().__init__(sim, medium, addr, pos, cfg)
+        self.interval_s = interval_s
+        self.neighbours_x16 = 0
+        self.probability = RELAY_PRUNE_ALWAYS
+        self.pruned = 0
+        self._hits = 0
+        self._misses = 0
+        sim.after(int(interval_s * 1e6), self._estimate)
+
+    def should_relay(self, pdu):
+        if self.probability >= RELAY_PRUNE_ALWAYS or self.sim.rng.randrange(256) < self.probability:
+            return True
+        self.pruned += 1
+        return False
+
+    def _estimate(self):
+        self.sim.after(int(self.interval_s * 1e6), self._estimate)
+        new = self.cache.misses - self._misses
+        duplicates = self.cache.hits - self._hits
+        if new < RELAY_PRUNE_MIN_SAMPLES:
+            return
+        self._hits, self._misses = self.cache.hits, self.cache.misses
+        copies = self.cfg.relay_retransmit_count + 1
+        neighbours = duplicates * 16 // (new * copies)
+        neighbours = neighbours * RELAY_PRUNE_ALWAYS // self.probability
+        self.neighbours_x16 = neighbours if self.neighbours_x16 == 0 else (3 * self.neighbours_x16 + neighbours) // 4
+        if self.neighbours_x16 <= RELAY_PRUNE_COVERAGE * 16:
+            self.probability = RELAY_PRUNE_ALWAYS
+        else:
+            self.probability = RELAY_PRUNE_COVERAGE * 16 * RELAY_PRUNE_ALWAYS // self.neighbours_x16
+        self.probability = max(self.probability, RELAY_PRUNE_MIN_PROBABILITY)
+
+
+# ADAPTIVE_TX parameters, see adaptive_tx.c
+ADAPTIVE_TX_INTERVAL_S = 30
+ADAPTIVE_TX_MIN_SAMPLES = 20
+ADAPTIVE_TX_SPARSE = 4 * 16
+ADAPTIVE_TX_DENSE = 12 * 16
+
+
+class AdaptiveNode(MeshNode):
+    """Node with ADAPTIVE_TX: network transmit and relay retransmit counts between min_count and
+    max_count from the copies of each new PDU heard in the network cache."""
+
+    def __init__(self, sim, medium, addr, pos, cfg, min_count=1, max_count=4, interval_s=ADAPTIVE_TX_INTERVAL_S):
+        cfg = copy.copy(cfg)
+        super().__init__(sim, medium, addr, pos, cfg)
+        self.min_count = min_count
+        self.max_count = max_count
+        self.interval_s = interval_s
+        self.copies_x16 = 0
+        self.increases = 0
+        self.decreases = 0
+        self._hits = 0
+        self._misses = 0
+        self._set_count(max_count)
+        sim.after(int(interval_s * 1e6), self._adapt)
+
+    def _set_count(self, count):
+        self.cfg.network_transmit_count = count
+        self.cfg.relay_retransmit_count = count
+
+    def _adapt(self):
+        self.sim.after(int(self.interval_s * 1e6), self._adapt)
+        new = self.cache.misses - self._misses
+        duplicates = self.cache.hits - self._hits
+        if new < ADAPTIVE_TX_MIN_SAMPLES:
+            return
+        self._hits, self._misses = self.cache.hits, self.cache.misses
+        copies = (new + duplicates) * 16 // new
+        self.copies_x16 = copies if self.copies_x16 == 0 else (self.copies_x16 + copies) // 2
+        count = self.cfg.relay_retransmit_count
+        if self.copies_x16 < ADAPTIVE_TX_SPARSE and count < self.max_count:
+            self._set_count(count + 1)
+            self.increases += 1
+        elif self.copies_x16 > ADAPTIVE_TX_DENSE and count > self.min_count:
+            self._set_count(count - 1)
+            self.decreases += 1
+
+
+# DIRECTED_FWD parameters, see directed_fwd.c
+DIRECTED_FWD_MIN_MESSAGES = 3           # unicast messages to a destination in the window before a path is discovered
+DIRECTED_FWD_WINDOW_S = 60
+DIRECTED_FWD_DISCOVERY_TIMEOUT_S = 2    # path origin floods again and retries after this time without Path Reply
+PATH_REPLY_DELAY_US = 150000            # path target waits for the Path Requests which took other routes
+
+
+class DirectedNode(MeshNode):
+    """Node with Mesh 1.1 directed forwarding.
+
+    Network PDUs are (src, seq, ttl, dst, kind, via, next_hop).  Kind is "flood" for managed
+    flooding, "directed" for PDUs relayed only by the forwarding nodes of a path, "preq" for
+    the flooded Path Request and "prep" for the Path Reply which goes back hop by hop to the
+    node the request was first received from (via).  Every node on the reply route adds the
+    bidirectional path between the origin and the target to its forwarding table.  A path
+    origin floods until DIRECTED_FWD_MIN_MESSAGES messages to the destination in the window
+    make it start the path discovery, with directed=False the node only floods."""
+
+    def __init__(self, sim, medium, addr, pos, cfg, directed=True):
+        super().__init__(sim, medium, addr, pos, cfg)
+        self.directed = directed
+        self.paths = set()          # forwarding table, frozenset of path origin and target
+        self.routes = set()         # destinations with a path from this node
+        self.delivered_at = {}      # (src, seq) -> time the PDU addressed to this node was received
+        self.discoveries = 0
+        self._prev = {}             # (origin, target) -> node the Path Request was first received from
+        self._sent = {}             # destination -> times of unicast messages in the window
+        self._pending = {}          # destination -> time the discovery started
+
+    def send_to(self, dst, ttl=DEFAULT_TTL):
+        """Send a unicast message.  Returns the PDU."""
+        now = self.sim.now
+        times = [t for t in self._sent.get(dst, []) if t > now - DIRECTED_FWD_WINDOW_S * 1e6] + [now]
+        self._sent[dst] = times
+        kind = "directed" if dst in self.routes else "flood"
+        pdu = self._originate(dst, ttl, kind)
+        if (self.directed and kind == "flood" and len(times) >= DIRECTED_FWD_MIN_MESSAGES and
+                now - self._pending.get(dst, -1e12) > DIRECTED_FWD_DISCOVERY_TIMEOUT_S * 1e6):
+            self._pending[dst] = now
+            self.discoveries += 1
+            self._originate(dst, ttl, "preq")
+        return pdu
+
+    def _originate(self, dst, ttl, kind, next_hop=None):
+        self._seq += 1
+        pdu = (self.addr, self._seq, ttl, dst, kind, self.addr, next_hop)
+        self.cache.check(self.addr, self._seq)
+        self.stats.published += 1
+        self._transmit(pdu, self.cfg.network_transmit_count, self.cfg.network_transmit_interval_ms, 0)
+        return pdu
+
+    def receive(self, pdu):
+        src, seq, ttl, dst, kind, via, next_hop = pdu
+        self.stats.received += 1
+        if kind == "prep" and next_hop != self.addr:
+            return
+        if self.cache.check(src, seq):
+            return
+        if kind == "preq":
+            self._prev[(src, dst)] = via
+        if dst == self.addr:
+            self.stats.delivered.add((src, seq))
+            self.delivered_at[(src, seq)] = self.sim.now
+            if kind == "preq":
+                self.paths.add(frozenset((src, dst)))
+                self.sim.after(PATH_REPLY_DELAY_US, self._originate, src, DEFAULT_TTL, "prep", via)
+            elif kind == "prep":
+                self.routes.add(src)
+                self.paths.add(frozenset((src, dst)))
+            return
+        if not self.cfg.relay or ttl < 2:
+            return
+        if kind == "prep":
+            # Reply goes from the path target to the path origin
+            self.paths.add(frozenset((src, dst)))
+            next_hop = self._prev.get((dst, src))
+            if next_hop is None:
+                return
+        elif kind == "directed" and frozenset((src, dst)) not in self.paths:
+            return
+        self.stats.relayed += 1
+        self._transmit((src, seq, ttl - 1, dst, kind, self.addr, next_hop), self.cfg.relay_retransmit_count,
+                       self.cfg.relay_retransmit_interval_ms, self.sim.rng.randrange(RELAY_DELAY_MAX_US), relay=True)
+
+
+# EXT_ADV_BEARER parameters, see ext_adv.c
+EXT_ADV_AUX_OFFSET_US = 300             # AUX_ADV_IND starts after the last ADV_EXT_IND
+EXT_ADV_HEADER_LEN = 9                  # extended header of AUX_ADV_IND: flags, AdvA, ADI
+EXT_ADV_MAX_NET_PDU_LEN = 229           # 254 bytes of advertising data less the AD length and type
+NET_OVERHEAD_LEN = 9 + 1 + 4 + 4        # network header, lower transport header, TransMIC, NetMIC
+SEG_PAYLOAD_LEN = 12                    # upper transport bytes in one segment
+UNSEG_MAX_LEN = 15                      # upper transport bytes in an unsegmented message
+SECONDARY_CHANNELS = tuple(range(37))
+
+
+class ExtAdvMedium(RangeMedium):
+    """RangeMedium with the extended advertising bearer.  A long network PDU is announced by
+    ADV_EXT_IND on the primary channels and sent once in AUX_ADV_IND on a random secondary
+    channel.  A node receives it if it got an ADV_EXT_IND on its scan channel and the
+    AUX_ADV_IND did not collide."""
+
+    def __init__(self, sim, range_m):
+        super().__init__(sim, range_m)
+        self.ext_len = {}           # (src, seq) -> network PDU length of PDUs sent with the extended bearer
+        for channel in SECONDARY_CHANNELS:
+            self._by_channel.setdefault(channel, [])
+
+    def broadcast(self, sender, pdu):
+        length = self.ext_len.get(pdu[:2])
+        if length is None:
+            return super().broadcast(sender, pdu)
+        event = self.send(sender, 0)
+        start = self.event_end(event) + EXT_ADV_AUX_OFFSET_US
+        aux = Transmission(sender, self.sim.rng.choice(SECONDARY_CHANNELS), start, start + adv_airtime_us(EXT_ADV_HEADER_LEN + length))
+        self._by_channel[aux.channel].append(aux)
+        self.airtime_us += aux.end - self.event_end(event)
+        sender.tx_until = aux.end
+        self.sim.at(aux.end, self._deliver_ext, sender, event, aux, pdu)
+        return event + [aux]
+
+    def _deliver_ext(self, sender, event, aux, pdu):
+        for node in sender.neighbours:
+            if self.received(node, event, node.scan_phase_us) and not self._collided(aux, node):
+                node.receive(pdu)
+
+    @staticmethod
+    def ext_event_us(length):
+        return (len(ADV_CHANNELS) * (adv_airtime_us(0) + ADV_CHANNEL_SWITCH_US) + EXT_ADV_AUX_OFFSET_US +
+                adv_airtime_us(EXT_ADV_HEADER_LEN + length))
+
+
+class ExtAdvNode(MeshNode):
+    """Node which sends access messages of any length.  With ext=True a message that fits in a
+    long network PDU is sent and relayed as one extended advertising PDU, otherwise messages
+    longer than an unsegmented message are sent in segments of SEG_PAYLOAD_LEN bytes, one every
+    sar_interval_ms."""
+
+    def __init__(self, sim, medium, addr, pos, cfg, ext=True, sar_interval_ms=60):
+        super().__init__(sim, medium, addr, pos, cfg)
+        self.ext = ext
+        self.sar_interval_ms = sar_interval_ms
+        self.delivered_at = {}      # (src, seq) -> time of the first reception
+
+    def send_message(self, access_len, ttl=DEFAULT_TTL):
+        """Returns list of (src, seq) of the network PDUs, filled as the segments are sent."""
+        keys = []
+        upper_len = access_len + 4
+        if self.ext and upper_len > UNSEG_MAX_LEN and access_len + NET_OVERHEAD_LEN <= EXT_ADV_MAX_NET_PDU_LEN:
+            self.medium.ext_len[(self.addr, self._seq + 1)] = access_len + NET_OVERHEAD_LEN
+            keys.append(self.publish(ttl)[:2])
+        elif upper_len <= UNSEG_MAX_LEN:
+            keys.append(self.publish(ttl)[:2])
+        else:
+            segments = (upper_len + SEG_PAYLOAD_LEN - 1) // SEG_PAYLOAD_LEN
+            keys.append(self.publish(ttl)[:2])
+            for i in range(1, segments):
+                self.sim.after(i * self.sar_interval_ms * 1000, lambda: keys.append(self.publish(ttl)[:2]))
+        return keys
+
+    def receive(self, pdu):
+        key = pdu[:2]
+        new = key not in self.stats.delivered
+        super().receive(pdu)
+        if new and key in self.stats.delivered:
+            self.delivered_at[key] = self.sim.now
+
+    def _transmit(self, pdu, retransmit_count, interval_ms, delay_us, relay=False):
+        length = self.medium.ext_len.get(pdu[:2]) if isinstance(self.medium, ExtAdvMedium) else None
+        if length is None:
+            return super()._transmit(pdu, retransmit_count, interval_ms, delay_us, relay)
+        airtime = ExtAdvMedium.ext_event_us(length)
+        start = max(self.sim.now + delay_us, self._busy_until)
+        for i in range(retransmit_count + 1):
+            t = max(start + i * interval_ms * 1000 + self.sim.rng.randrange(10000), self._busy_until)
+            self._busy_until = t + airtime
+            self.sim.at(t, self._send, pdu, relay)
@@ -0,0 +1,141 @@
+"""
+LE Coded PHY on the LPN-friend link.
+
+The link has a mean RSSI, slow fading which changes from one poll cycle to the next
+(Gauss-Markov, the LPN or people around it move) and fast fading per packet.  A packet is
+received if its RSSI is above the sensitivity of the PHY and it did not collide.  The
+friend answers on the PHY the Poll was received on.  Coded PHY S8 gains about 9 dB of
+sensitivity for 8 times the air time.
+
+With policy "adaptive" the LPN selects the PHY like coded_phy.c: it keeps moving averages
+of the first attempt success rate and of the response RSSI and moves to coded PHY when the
+link is weak or lossy, back to 1M when it is strong again.  When CODED_PHY_MAX_FAILED poll
+cycles on coded PHY fail after all retries and no response has been received on coded PHY
+since the switch, the friend is taken as not supporting it and the LPN stays on 1M for
+CODED_PHY_RETRY seconds.
+"""
+
+import math
+
+from .friendship import Lpn
+from .radio import ADV_CHANNELS, SCAN_WINDOW_US
+
+# name, us per byte, sensitivity in dBm (CYW20819 typical)
+PHYS = {
+    "1m": (8, -95.0),
+    "coded": (64, -104.0),
+}
+POLICIES = ("1m", "coded", "adaptive")
+
+SLOW_FADING_DB = 4.0            # standard deviation of the slow fading
+SLOW_FADING_RHO = 0.9           # correlation of the slow fading between poll cycles
+FAST_FADING_DB = 2.0            # standard deviation per packet
+
+# CODED_PHY parameters, see coded_phy.c
+CODED_PHY_ENTER_SUCCESS = 192   # 1/256 units, first attempt success below 75% moves to coded PHY
+CODED_PHY_EXIT_SUCCESS = 230    # 1/256 units, 90% needed to move back to 1M
+CODED_PHY_ENTER_RSSI = -91      # response RSSI below moves to coded PHY, 4 dB above 1M sensitivity
+CODED_PHY_EXIT_RSSI = -85       # response RSSI above moves back to 1M
+CODED_PHY_HOLD_CYCLES = 8       # poll cycles after a change before the next one
+CODED_PHY_MAX_FAILED = 3        # failed poll cycles on coded PHY before falling back to 1M
+CODED_PHY_RETRY = 3600          # seconds before coded PHY is tried again after a fallback
+
+
+class CodedLpn(Lpn):
+    def __init__(self, sim, medium, friend, addr, low_power, first_poll_us, rssi_dbm, policy="adaptive", **kwargs):
+        self.rssi_dbm = rssi_dbm
+        self.policy = policy
+        self.phy = "coded" if policy == "coded" else "1m"
+        self.switches = 0
+        self.fallbacks = 0
+        self.coded_cycles = 0
+        self.first_failures = 0     # poll cycles without a response to the first Poll
+        self.success = 256          # moving average of first attempt success, 1/256 units
+        self.rssi_avg = None        # moving average of the response RSSI
+        self._slow_db = 0.0
+        self._hold = 0
+        self._last_rssi = None
+        self._failed = 0            # consecutive failed poll cycles on coded PHY
+        self._coded_answered = False
+        self._coded_disabled_until = 0
+        super().__init__(sim, medium, friend, addr, low_power, first_poll_us, **kwargs)
+
+    @property
+    def us_per_byte(self):
+        return PHYS[self.phy][0]
+
+    def _poll_cycle(self):
+        rng = self.sim.rng
+        self._slow_db = SLOW_FADING_RHO * self._slow_db + math.sqrt(1 - SLOW_FADING_RHO ** 2) * rng.gauss(0, SLOW_FADING_DB)
+        if self.phy == "coded":
+            self.coded_cycles += 1
+        super()._poll_cycle()
+
+    def link_received(self, event, receiver, scan_phase_us=0):
+        # A Coded PHY event is longer than the scan channel changes of Medium.received, the
+        # receiver stays on the channel it scanned when the event started
+        channel = ADV_CHANNELS[((event[0].start + scan_phase_us) // SCAN_WINDOW_US) % len(ADV_CHANNELS)]
+        if not any(tx.channel == channel and not self.medium._collided(tx, receiver) for tx in event):
+            return False
+        rssi = self.rssi_dbm + self._slow_db + self.sim.rng.gauss(0, FAST_FADING_DB)
+        if rssi < PHYS[self.phy][1]:
+            return False
+        if receiver is self:
+            self._last_rssi = rssi
+        return True
+
+    def response(self, event, window_start, window_end, more_data, entry):
+        first = self._attempt == 0 and self._first_response
+        received = super().response(event, window_start, window_end, more_data, entry)
+        if received:
+            self._failed = 0
+            if self.phy == "coded":
+                self._coded_answered = True
+        if received and first:
+            self._cycle_done(True)
+        return received
+
+    def _window_closed(self, window_start, window_end):
+        if not self._got_response and self._attempt == 0 and self._first_response:
+            self._cycle_done(False)
+        failed_cycles = self.stats.failed_cycles
+        super()._window_closed(window_start, window_end)
+        if self.stats.failed_cycles != failed_cycles:
+            self._poll_failed()
+
+    def _poll_failed(self):
+        # A friend which never answered on coded PHY since the switch does not support it
+        if self.policy != "adaptive" or self.phy != "coded" or self._coded_answered:
+            return
+        self._failed += 1
+        if self._failed >= CODED_PHY_MAX_FAILED:
+            self.fallbacks += 1
+            self._coded_disabled_until = self.sim.now + CODED_PHY_RETRY * 1000000
+            self._switch("1m")
+
+    def _cycle_done(self, success):
+        if not success:
+            self.first_failures += 1
+        self.success = (7 * self.success + (256 if success else 0)) // 8
+        if success:
+            self.rssi_avg = self._last_rssi if self.rssi_avg is None else (7 * self.rssi_avg + self._last_rssi) / 8
+        if self.policy != "adaptive":
+            return
+        if self._hold > 0:
+            self._hold -= 1
+            return
+        weak = self.rssi_avg is not None and self.rssi_avg < CODED_PHY_ENTER_RSSI
+        strong = self.rssi_avg is not None and self.rssi_avg > CODED_PHY_EXIT_RSSI
+        if self.phy == "1m" and (self.success < CODED_PHY_ENTER_SUCCESS or weak) and self.sim.now >= self._coded_disabled_until:
+            self._switch("coded")
+        elif self.phy == "coded" and self.success >= CODED_PHY_EXIT_SUCCESS and strong:
+            self._switch("1m")
+
+    def _switch(self, phy):
+        self.phy = phy
+        self.switches += 1
+        self._hold = CODED_PHY_HOLD_CYCLES
+        self._failed = 0
+        self._coded_answered = False
+        # Success on the new PHY starts from a clean state
+        self.success = 256
@@ -0,0 +1,77 @@
+"""
+Advertising bearer.  Every PDU is sent as an advertising event on the three primary
+advertising channels.  A receiver scans one channel at a time and receives the PDU if
+the copy on its current channel does not overlap with any other transmission on that
+channel and the receiver itself is not transmitting.
+"""
+
+ADV_CHANNELS = (37, 38, 39)
+ADV_CHANNEL_SWITCH_US = 150         # gap between copies of one advertising event
+ADV_OVERHEAD_BYTES = 1 + 4 + 2 + 6 + 2 + 3  # preamble, access address, header, AdvA, AD length/type, CRC
+SCAN_WINDOW_US = 30000              # receiver switches scan channel every scan window
+
+
+def adv_airtime_us(network_pdu_len, us_per_byte=8):
+    return (ADV_OVERHEAD_BYTES + network_pdu_len) * us_per_byte
+
+
+class Transmission:
+    __slots__ = ("sender", "channel", "start", "end")
+
+    def __init__(self, sender, channel, start, end):
+        self.sender = sender
+        self.channel = channel
+        self.start = start
+        self.end = end
+
+
+class Medium:
+    def __init__(self, sim):
+        self.sim = sim
+        self._tx = []
+        self.transmissions = 0
+
+    def send(self, sender, network_pdu_len, us_per_byte=8, channels=ADV_CHANNELS):
+        """Schedule advertising event starting now.  Returns list of channel transmissions."""
+        airtime = adv_airtime_us(network_pdu_len, us_per_byte)
+        start = self.sim.now
+        event = []
+        for channel in channels:
+            tx = Transmission(sender, channel, start, start + airtime)
+            self._tx.append(tx)
+            event.append(tx)
+            start += airtime + ADV_CHANNEL_SWITCH_US
+        self.transmissions += 1
+        if len(self._tx) > 1000:
+            self.prune(self.sim.now - 100000)
+        return event
+
+    def event_end(self, event):
+        return event[-1].end
+
+    def received(self, receiver, event, scan_phase_us=0):
+        """True if receiver got at least the copy on the channel it was scanning.
+        Must be called after the end of the event."""
+        for tx in event:
+            scan_channel = ADV_CHANNELS[((tx.start + scan_phase_us) // SCAN_WINDOW_US) % len(ADV_CHANNELS)]
+            if scan_channel != tx.channel:
+                continue
+            if not self._collided(tx, receiver):
+                return True
+        return False
+
+    def busy(self, tx):
+        return self._collided(tx, None)
+
+    def _collided(self, tx, receiver):
+        for other in self._tx:
+            if other is tx or other.end <= tx.start or other.start >= tx.end:
+                continue
+            if other.sender is receiver:
+                return True     # half duplex, receiver was transmitting
+            if other.channel == tx.channel:
+                return True
+        return False
+
+    def prune(self, older_than_us):
+        self._tx = [tx for tx in self._tx if tx.end > older_than_us]
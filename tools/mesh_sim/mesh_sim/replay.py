@@ -0,0 +1,104 @@
+"""
+Replay protection list of replay_list.c: open addressing hash table with linear probing,
+backward shift deletion and dirty record tracking for batched NVRAM writes.
+"""
+
+RECORD_ENTRIES = 32             # REPLAY_LIST_RECORD_ENTRIES
+FLUSH_UPDATES = 1024            # REPLAY_LIST_FLUSH_UPDATES
+FLUSH_INTERVAL_S = 60           # REPLAY_LIST_FLUSH_INTERVAL
+
+
+def table_size(sources):
+    """Smallest power of 2 REPLAY_LIST_SIZE which holds the sources at 75% load."""
+    size = 32
+    while size * 3 // 4 < sources:
+        size *= 2
+    return size
+
+
+class ReplayList:
+    def __init__(self, size):
+        self.size = size
+        self.src = [0] * size
+        self.seq = [0] * size
+        self.sources = 0
+        self.dirty = set()
+        self.probes = 0
+
+    def hash(self, src):
+        return (((src * 40503) & 0xffff) * self.size) >> 16
+
+    def find(self, src):
+        slot = self.hash(src)
+        while self.src[slot]:
+            self.probes += 1
+            if self.src[slot] == src:
+                return slot
+            slot = (slot + 1) & (self.size - 1)
+        self.probes += 1
+        return -1
+
+    def insert(self, src):
+        slot = self.hash(src)
+        while self.src[slot]:
+            self.probes += 1
+            slot = (slot + 1) & (self.size - 1)
+        self.probes += 1
+        self.src[slot] = src
+        self.seq[slot] = 0
+        self.sources += 1
+        return slot
+
+    def remove(self, slot):
+        mask = self.size - 1
+        hole = slot
+        nxt = (hole + 1) & mask
+        self.dirty.add(hole // RECORD_ENTRIES)
+        while self.src[nxt]:
+            home = self.hash(self.src[nxt])
+            if ((nxt - home) & mask) >= ((nxt - hole) & mask):
+                self.src[hole], self.seq[hole] = self.src[nxt], self.seq[nxt]
+                self.dirty.add(nxt // RECORD_ENTRIES)
+                hole = nxt
+            nxt = (nxt + 1) & mask
+        self.src[hole] = 0
+        self.seq[hole] = 0
+        self.dirty.add(hole // RECORD_ENTRIES)
+        self.sources -= 1
+
+    def check(self, src, seq):
+        """Returns True and updates the list if the message is not a replay."""
+        slot = self.find(src)
+        if slot < 0:
+            slot = self.insert(src)
+        elif seq <= self.seq[slot]:
+            return False
+        self.seq[slot] = seq
+        self.dirty.add(slot // RECORD_ENTRIES)
+        return True
+
+    def flush(self):
+        """Returns number of NVRAM records written."""
+        written = len(self.dirty)
+        self.dirty.clear()
+        return written
+
+
+class LinearList:
+    """Replay list kept as an unsorted array, the baseline."""
+
+    def __init__(self):
+        self.entries = []
+        self.probes = 0
+
+    def check(self, src, seq):
+        for entry in self.entries:
+            self.probes += 1
+            if entry[0] == src:
+                if seq <= entry[1]:
+                    return False
+                entry[1] = seq
+                return True
+        self.probes += 1
+        self.entries.append([src, seq])
+        return True
@@ -0,0 +1,26 @@
+"""
+Event scheduler.  Time is kept in microseconds.
+"""
+
+import heapq
+import itertools
+
+
+class Simulator:
+    def __init__(self, rng):
+        self.now = 0
+        self.rng = rng
+        self._queue = []
+        self._seq = itertools.count()
+
+    def at(self, time_us, callback, *args):
+        heapq.heappush(self._queue, (int(time_us), next(self._seq), callback, args))
+
+    def after(self, delay_us, callback, *args):
+        self.at(self.now + delay_us, callback, *args)
+
+    def run(self, until_us):
+        while self._queue and self._queue[0][0] <= until_us:
+            self.now, _, callback, args = heapq.heappop(self._queue)
+            callback(*args)
+        self.now = until_us
@@ -0,0 +1,65 @@
+"""
+Traffic profile of a site.  The profile is a JSON file:
+
+{
+    "lpns_per_friend": 4,
+    "commands_per_hour": 6,             # commands sent to each LPN, Poisson arrivals
+    "burst": [1, 1, 1, 3],              # number of messages per command, picked at random
+    "burst_spacing_ms": 50,             # time between messages of one burst
+    "background_pdus_per_s": 2.0,       # other mesh traffic in range
+    "friends": [                        # friend candidates in range of the LPN
+        {"rssi": -55, "per": 0.02},
+        {"rssi": -80, "per": 0.15, "receive_window": 50}
+    ]
+}
+
+Friend candidates without receive_window use the value being evaluated.  "per" is the
+packet error rate of the LPN-friend link in addition to collisions.
+"""
+
+import json
+from dataclasses import dataclass, field
+
+
+@dataclass
+class TrafficProfile:
+    lpns_per_friend: int = 4
+    commands_per_hour: float = 6.0
+    burst: list = field(default_factory=lambda: [1])
+    burst_spacing_ms: int = 50
+    background_pdus_per_s: float = 2.0
+    friends: list = field(default_factory=lambda: [{"rssi": -60, "per": 0.02}])
+
+    @classmethod
+    def load(cls, path):
+        with open(path) as f:
+            data = json.load(f)
+        return cls(**data)
+
+
+class CommandSource:
+    """Sends commands to one LPN through its friend."""
+
+    def __init__(self, sim, friend, lpn_addr, profile, on_sent=None):
+        self.sim = sim
+        self.friend = friend
+        self.lpn_addr = lpn_addr
+        self.profile = profile
+        self.on_sent = on_sent
+        self.sent = 0
+        if profile.commands_per_hour > 0:
+            self._next()
+
+    def _next(self):
+        self.sim.after(int(self.sim.rng.expovariate(self.profile.commands_per_hour / 3600.0) * 1e6), self._command)
+
+    def _command(self):
+        for i in range(self.sim.rng.choice(self.profile.burst)):
+            self.sim.after(i * self.profile.burst_spacing_ms * 1000, self._message)
+        self._next()
+
+    def _message(self):
+        self.sent += 1
+        self.friend.enqueue(self.lpn_addr)
+        if self.on_sent:
+            self.on_sent(self.lpn_addr)
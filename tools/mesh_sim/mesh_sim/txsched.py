@@ -0,0 +1,181 @@
+"""
+Transmit scheduler of a node.  All advertising PDUs a node sends (friend responses,
+relayed PDUs, beacons, proxy advertisements) share one radio and are sent one
+advertising event at a time.  GATT connection events are reserved at fixed times by
+the link layer and cannot be moved.
+
+Each job has a release time (earliest start) and a deadline (latest start).  A job that
+cannot start before its deadline is dropped and counted as missed.
+
+Policies:
+    fifo - jobs are sent in the order they were released
+    edf  - earliest deadline first among released jobs
+"""
+
+import itertools
+
+from .radio import adv_airtime_us, ADV_CHANNEL_SWITCH_US
+
+POLICIES = ("fifo", "edf")
+
+
+class TxClassStats:
+    def __init__(self):
+        self.sent = 0
+        self.missed = 0
+        self.delay_us = []      # release to start of transmission
+
+
+class TxJob:
+    __slots__ = ("kind", "pdu_len", "release", "deadline", "on_sent", "on_missed", "seq", "us_per_byte")
+
+    def __init__(self, kind, pdu_len, release, deadline, on_sent, on_missed, seq, us_per_byte=8):
+        self.kind = kind
+        self.pdu_len = pdu_len
+        self.us_per_byte = us_per_byte
+        self.release = release
+        self.deadline = deadline
+        self.on_sent = on_sent
+        self.on_missed = on_missed
+        self.seq = seq
+
+
+class TxScheduler:
+    def __init__(self, sim, medium, node, policy="fifo"):
+        if policy not in POLICIES:
+            raise ValueError("unknown policy %s" % policy)
+        self.sim = sim
+        self.medium = medium
+        self.node = node
+        self.policy = policy
+        self.stats = {}
+        self.depth_max = 0
+        self._jobs = []
+        self._reservations = []     # (start, end) of connection events
+        self._busy_until = 0
+        self._seq = itertools.count()
+        self._kick_at = None
+
+    def submit(self, kind, pdu_len, release_us, deadline_us=None, on_sent=None, on_missed=None, us_per_byte=8):
+        job = TxJob(kind, pdu_len, max(release_us, self.sim.now), deadline_us, on_sent, on_missed, next(self._seq), us_per_byte)
+        self._jobs.append(job)
+        self.depth_max = max(self.depth_max, len(self._jobs))
+        self._stats(kind)
+        self._kick()
+
+    def reserve(self, start_us, duration_us):
+        """Reserve the radio for a connection event."""
+        self._reservations.append((start_us, start_us + duration_us))
+
+    def queue_depth(self):
+        return len(self._jobs)
+
+    def _stats(self, kind):
+        if kind not in self.stats:
+            self.stats[kind] = TxClassStats()
+        return self.stats[kind]
+
+    @staticmethod
+    def event_us(pdu_len, us_per_byte=8):
+        return 3 * (adv_airtime_us(pdu_len, us_per_byte) + ADV_CHANNEL_SWITCH_US)
+
+    def _schedule_kick(self, time_us):
+        if self._kick_at is not None and self._kick_at <= time_us and self._kick_at > self.sim.now:
+            return
+        self._kick_at = time_us
+        self.sim.at(time_us, self._kick)
+
+    def _kick(self):
+        now = self.sim.now
+        if now < self._busy_until:
+            self._schedule_kick(self._busy_until)
+            return
+        self._reservations = [r for r in self._reservations if r[1] > now]
+
+        # drop jobs which can no longer start in time
+        for job in [j for j in self._jobs if j.deadline is not None and j.deadline < now]:
+            self._jobs.remove(job)
+            self._stats(job.kind).missed += 1
+            if job.on_missed:
+                job.on_missed()
+
+        released = [j for j in self._jobs if j.release <= now]
+        if not released:
+            if self._jobs:
+                self._schedule_kick(min(j.release for j in self._jobs))
+            return
+
+        if self.policy == "edf":
+            job = min(released, key=lambda j: (j.deadline if j.deadline is not None else float("inf"), j.seq))
+        else:
+            job = min(released, key=lambda j: (j.release, j.seq))
+
+        duration = self.event_us(job.pdu_len, job.us_per_byte)
+        for start, end in self._reservations:
+            if start < now + duration and end > now:
+                self._schedule_kick(end)
+                return
+
+        self._jobs.remove(job)
+        stats = self._stats(job.kind)
+        stats.sent += 1
+        stats.delay_us.append(now - job.release)
+        event = self.medium.send(self.node, job.pdu_len, job.us_per_byte)
+        self._busy_until = self.medium.event_end(event)
+        if job.on_sent:
+            self.sim.at(self._busy_until, job.on_sent, event)
+        self._schedule_kick(self._busy_until)
+
+
+class ConnectionEvents:
+    """GATT proxy connection, the link layer reserves the radio every connection interval."""
+
+    def __init__(self, sim, scheduler, interval_ms, event_us=2500):
+        self.sim = sim
+        self.scheduler = scheduler
+        self.interval_us = int(interval_ms * 1000)
+        self.event_us = event_us
+        if interval_ms > 0:
+            sim.at(sim.rng.randrange(self.interval_us), self._event)
+
+    def _event(self):
+        self.scheduler.reserve(self.sim.now, self.event_us)
+        self.sim.after(self.interval_us, self._event)
+
+
+class PeriodicTx:
+    """Periodic advertising of a node, for example proxy advertisements or beacons."""
+
+    def __init__(self, sim, scheduler, kind, interval_ms, pdu_len, slack_ms=10):
+        self.sim = sim
+        self.scheduler = scheduler
+        self.kind = kind
+        self.interval_us = int(interval_ms * 1000)
+        self.pdu_len = pdu_len
+        self.slack_us = int(slack_ms * 1000)
+        if interval_ms > 0:
+            sim.at(sim.rng.randrange(self.interval_us), self._tx)
+
+    def _tx(self):
+        self.scheduler.submit(self.kind, self.pdu_len, self.sim.now, self.sim.now + self.slack_us)
+        self.sim.after(self.interval_us, self._tx)
+
+
+class RelayTraffic:
+    """PDUs heard by the node and relayed, Poisson arrivals."""
+
+    def __init__(self, sim, scheduler, rate_per_s, pdu_len=29, max_delay_ms=20):
+        self.sim = sim
+        self.scheduler = scheduler
+        self.rate_per_s = rate_per_s
+        self.pdu_len = pdu_len
+        self.max_delay_us = int(max_delay_ms * 1000)
+        if rate_per_s > 0:
+            self._next()
+
+    def _next(self):
+        self.sim.after(int(self.sim.rng.expovariate(self.rate_per_s) * 1e6), self._relay)
+
+    def _relay(self):
+        self.scheduler.submit("relay", self.pdu_len, self.sim.now, self.sim.now + self.max_delay_us)
+        self._next()
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""
+Relay network message cache size.
+
+Lighting nodes on a grid all relay.  Every node publishes at random, a node drops a
+network PDU found in its network message cache and relays the others.  When the cache is
+too small for the PDUs in flight, an entry is evicted before the last copy of the PDU
+arrives and the node relays the PDU again.  The scenario runs the mesh with different
+NET_CACHE_SIZE values and reports relay transmissions per published message
+(amplification), PDUs relayed again after eviction, delivery ratio and cache counters.
+
+    python3 relay_cache.py --cols 6 --rows 6 --rate 5 --sizes 2,4,8,16,32,64
+"""
+
+import argparse
+import random
+
+from mesh_sim.mesh import RangeMedium, NodeConfig, grid
+from mesh_sim.sim import Simulator
+
+
+def run(cache_size, args):
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = RangeMedium(sim, args.range)
+    cfg = NodeConfig(net_cache_size=cache_size)
+    nodes = grid(sim, medium, args.cols, args.rows, args.spacing, cfg, jitter_m=args.spacing / 4)
+    published = []
+
+    def publish():
+        # Messages of the last 2 seconds may still be in flight at the end
+        pdu = rng.choice(nodes).publish()
+        if sim.now < (args.duration - 2) * 1e6:
+            published.append(pdu)
+        sim.after(int(rng.expovariate(args.rate) * 1e6), publish)
+
+    sim.after(0, publish)
+    sim.run(int(args.duration * 1e6))
+    return nodes, published
+
+
+def report(label, nodes, published, extra=""):
+    relay_tx = sum(n.stats.relay_tx for n in nodes)
+    leaked = sum(n.stats.leaked for n in nodes)
+    reach = 0
+    for src, seq, _ in published:
+        reach += sum(1 for n in nodes if n.addr == src or (src, seq) in n.stats.delivered)
+    count = max(len(published), 1)
+    return "%-8s %8d %10.1f %10.2f %9.3f %s" % (label, len(published), relay_tx / count, leaked / count,
+                                                  reach / (count * len(nodes)), extra)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--cols", type=int, default=6)
+    parser.add_argument("--rows", type=int, default=6)
+    parser.add_argument("--spacing", type=float, default=6.0, help="grid spacing in m")
+    parser.add_argument("--range", type=float, default=13.0, help="radio range in m")
+    parser.add_argument("--rate", type=float, default=5.0, help="messages published per second in the network")
+    parser.add_argument("--sizes", default="2,4,8,16,32,64", help="comma separated NET_CACHE_SIZE values")
+    parser.add_argument("--duration", type=float, default=60, help="simulated time in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%-8s %8s %10s %10s %9s %8s %8s %9s" % ("size", "messages", "relay tx", "leaked", "delivery",
+                                                  "hits", "misses", "evictions"))
+    for size in [int(v) for v in args.sizes.split(",")]:
+        nodes, published = run(size, args)
+        hits = sum(n.cache.hits for n in nodes)
+        misses = sum(n.cache.misses for n in nodes)
+        evictions = sum(n.cache.evictions for n in nodes)
+        print(report(str(size), nodes, published, "%8d %8d %9d" % (hits, misses, evictions)))
+
+
+if __name__ == "__main__":
+    main()
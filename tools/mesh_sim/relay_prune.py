@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Density aware relay pruning.
+
+Lighting nodes are placed on grids of different density and on a corridor.  All nodes
+relay, or with RELAY_PRUNE each node estimates its relaying neighbours from the
+duplicates in its network message cache and relays with lower probability when it has
+more than enough of them.  Reports delivery ratio and relay air time per published
+message after the estimates have settled.
+
+    python3 relay_prune.py --rate 2 --duration 120 --warmup 60
+"""
+
+import argparse
+import random
+
+from mesh_sim.mesh import RangeMedium, NodeConfig, MeshNode, PruningNode, grid
+from mesh_sim.sim import Simulator
+
+# name, columns, rows, spacing in m
+TOPOLOGIES = (
+    ("dense", 6, 6, 3.0),
+    ("office", 6, 6, 6.0),
+    ("sparse", 6, 6, 10.0),
+    ("corridor", 12, 1, 8.0),
+)
+
+
+def run(topology, cls, args):
+    name, cols, rows, spacing = topology
+    rng = random.Random(args.seed)
+    sim = Simulator(rng)
+    medium = RangeMedium(sim, args.range)
+    nodes = grid(sim, medium, cols, rows, spacing, NodeConfig(), cls=cls, jitter_m=spacing / 4)
+    published = []
+    counted = {"relay_tx": 0, "airtime_us": 0}
+
+    def publish():
+        pdu = rng.choice(nodes).publish()
+        if args.warmup * 1e6 <= sim.now < (args.duration - 2) * 1e6:
+            published.append(pdu)
+        sim.after(int(rng.expovariate(args.rate) * 1e6), publish)
+
+    def warmup_done():
+        counted["relay_tx"] = sum(n.stats.relay_tx for n in nodes)
+        counted["airtime_us"] = medium.airtime_us
+
+    sim.after(0, publish)
+    sim.at(int(args.warmup * 1e6), warmup_done)
+    sim.run(int(args.duration * 1e6))
+
+    relay_tx = sum(n.stats.relay_tx for n in nodes) - counted["relay_tx"]
+    airtime_us = medium.airtime_us - counted["airtime_us"]
+    reach = 0
+    for src, seq, _ in published:
+        reach += sum(1 for n in nodes if n.addr == src or (src, seq) in n.stats.delivered)
+    count = max(len(published), 1)
+    neighbours = sum(len(n.neighbours) for n in nodes) / len(nodes)
+    return neighbours, reach / (count * len(nodes)), relay_tx / count, airtime_us / count / 1000.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--range", type=float, default=13.0, help="radio range in m")
+    parser.add_argument("--rate", type=float, default=2.0, help="messages published per second in the network")
+    parser.add_argument("--duration", type=float, default=120, help="simulated time in seconds")
+    parser.add_argument("--warmup", type=float, default=60, help="seconds before the measurement starts")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%-9s %10s %-7s %9s %9s %12s" % ("topology", "neighbours", "relay", "delivery", "relay tx", "air time ms"))
+    for topology in TOPOLOGIES:
+        for label, cls in (("all", MeshNode), ("prune", PruningNode)):
+            neighbours, delivery, relay_tx, airtime_ms = run(topology, cls, args)
+            print("%-9s %10.1f %-7s %9.3f %9.1f %12.1f" % (topology[0], neighbours, label, delivery, relay_tx, airtime_ms))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Replay protection list benchmark.
+
+Fills the hashed list of replay_list.c and a linear list with 100 to 2000 sources and
+measures probes per check for known sources, for new sources and after removals, and the
+host time per check.  Probes are the memory reads which dominate the check on the device.
+A message stream from the sources is then run for an hour to count NVRAM record writes
+with batched persistence against a write on every update.
+
+    python3 rpl_bench.py --sources 100,250,500,1000,2000 --rate 20
+"""
+
+import argparse
+import random
+import time
+
+from mesh_sim.replay import ReplayList, LinearList, table_size, FLUSH_UPDATES, FLUSH_INTERVAL_S
+
+
+def addresses(rng, count):
+    """Unicast addresses as assigned by a provisioner: mostly consecutive, some gaps."""
+    addrs = []
+    addr = 0x0002
+    while len(addrs) < count:
+        addrs.append(addr)
+        addr += 1 if rng.random() < 0.8 else rng.randrange(2, 16)
+    return addrs
+
+
+def bench_lookup(cls, addrs, checks, rng):
+    lst = cls()
+    start = time.perf_counter()
+    for i, addr in enumerate(addrs):
+        lst.check(addr, 1)
+    insert_s = time.perf_counter() - start
+    insert_probes = lst.probes / len(addrs)
+
+    lst.probes = 0
+    seq = 2
+    start = time.perf_counter()
+    for _ in range(checks):
+        lst.check(rng.choice(addrs), seq)
+        seq += 1
+    check_s = time.perf_counter() - start
+    return lst, insert_probes, insert_s / len(addrs) * 1e6, lst.probes / checks, check_s / checks * 1e6
+
+
+def flash_writes(lst, addrs, rate, rng, duration_s=3600):
+    """Returns (batched, per update) NVRAM record writes in duration_s."""
+    now = 0.0
+    first_dirty = None
+    updates = 0
+    batched = 0
+    messages = 0
+    seq = 1 << 20
+    while now < duration_s:
+        now += rng.expovariate(rate)
+        if first_dirty is not None and now - first_dirty >= FLUSH_INTERVAL_S:
+            batched += lst.flush()
+            first_dirty, updates = None, 0
+        seq += 1
+        if lst.check(rng.choice(addrs), seq):
+            messages += 1
+            updates += 1
+            if first_dirty is None:
+                first_dirty = now
+            if updates >= FLUSH_UPDATES:
+                batched += lst.flush()
+                first_dirty, updates = None, 0
+    return batched, messages
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--sources", default="100,250,500,1000,2000", help="comma separated numbers of sources")
+    parser.add_argument("--checks", type=int, default=20000, help="checks of known sources per measurement")
+    parser.add_argument("--rate", type=float, default=20.0, help="messages per second for the NVRAM write count")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%7s %6s %8s | %-34s | %-34s | %-22s" % ("", "", "", "hashed: probes/us per new, known",
+                                                     "linear: probes/us per new, known", "NVRAM writes per hour"))
+    print("%7s %6s %8s | %8s %8s %8s %7s | %8s %8s %8s %7s | %8s %8s %4s" % (
+        "sources", "slots", "RAM B", "new", "us", "known", "us", "new", "us", "known", "us", "batched", "each", "max"))
+    for count in [int(v) for v in args.sources.split(",")]:
+        rng = random.Random(args.seed)
+        addrs = addresses(rng, count)
+        size = table_size(count)
+        hashed = bench_lookup(lambda: ReplayList(size), addrs, args.checks, rng)
+        linear = bench_lookup(LinearList, addrs, args.checks, rng)
+
+        # Max probe length of a lookup for a known source
+        lst = hashed[0]
+        max_probes = 0
+        for addr in addrs:
+            lst.probes = 0
+            lst.find(addr)
+            max_probes = max(max_probes, lst.probes)
+
+        lst.flush()
+        batched, messages = flash_writes(lst, addrs, args.rate, rng)
+        print("%7d %6d %8d | %8.2f %8.2f %8.2f %7.2f | %8.1f %8.2f %8.1f %7.2f | %8d %8d %4d" % (
+            count, size, size * 8, hashed[1], hashed[2], hashed[3], hashed[4],
+            linear[1], linear[2], linear[3], linear[4], batched, messages, max_probes))
+    print("slots above 1024 (768 sources) do not fit the NVRAM records reserved by the firmware")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+"""
+Parameter sweep of mesh_config.low_power and mesh_config.friend_cfg.
+
+Every combination of the parameter values is simulated against a traffic profile
+(see mesh_sim/traffic.py).  The tool reports LPN average current, command latency and
+message loss for each combination and the Pareto frontier of the three metrics.  Each
+parameter accepts a comma separated list of values, defaults are the values used in
+low_power_led.c.
+
+    python3 sweep.py --profile profiles/office.json --poll-timeout 50,100,200,400 \\
+                     --receive-window 10,20,50 --csv sweep.csv
+"""
+
+import argparse
+import csv
+import itertools
+import random
+import sys
+
+from mesh_sim.config import LowPowerConfig, FriendConfig, spread_poll
+from mesh_sim.energy import EnergyModel
+from mesh_sim.friendship import Lpn, Friend, Background, LpnStats, select_friend, POLL_PDU_LEN
+from mesh_sim.radio import Medium, adv_airtime_us, ADV_CHANNEL_SWITCH_US
+from mesh_sim.sim import Simulator
+from mesh_sim.traffic import TrafficProfile, CommandSource
+
+PARAMETERS = (
+    # name, section, default
+    ("poll_timeout", "low_power", LowPowerConfig.poll_timeout),
+    ("receive_delay", "low_power", LowPowerConfig.receive_delay),
+    ("rssi_factor", "low_power", LowPowerConfig.rssi_factor),
+    ("receive_window_factor", "low_power", LowPowerConfig.receive_window_factor),
+    ("min_cache_size_log", "low_power", LowPowerConfig.min_cache_size_log),
+    ("receive_window", "friend_cfg", FriendConfig.receive_window),
+    ("cache_buf_len", "friend_cfg", FriendConfig.cache_buf_len),
+)
+METRICS = ("current_ua", "latency_p95_ms", "loss")
+
+
+def percentile(values, fraction):
+    if not values:
+        return float("nan")
+    values = sorted(values)
+    return values[min(int(fraction * len(values)), len(values) - 1)]
+
+
+def evaluate(point, profile, duration_s, seed, energy):
+    low_power = LowPowerConfig(**{k: v for k, v in point.items() if k in LowPowerConfig.__annotations__})
+    friend_cfg = FriendConfig(**{k: v for k, v in point.items() if k in FriendConfig.__annotations__})
+    result = dict(point)
+
+    chosen = select_friend(low_power, friend_cfg, profile.friends)
+    if chosen is None:
+        result.update(feasible=False, friend_rssi="", current_ua=float("inf"), latency_p50_ms=float("inf"),
+                      latency_p95_ms=float("inf"), loss=1.0, battery_days=0.0)
+        return result
+    friend_cfg.receive_window = chosen["receive_window"]
+
+    rng = random.Random(seed)
+    sim = Simulator(rng)
+    medium = Medium(sim)
+    friend = Friend(sim, medium, friend_cfg)
+    Background(sim, medium, profile.background_pdus_per_s)
+    lpns, sources = [], []
+    period_us = int(low_power.poll_timeout * 100000)
+    for i in range(profile.lpns_per_friend):
+        addr = 0x0010 + i
+        lpns.append(Lpn(sim, medium, friend, addr, spread_poll(low_power, addr), rng.randrange(period_us),
+                        link_per=chosen["per"]))
+        sources.append(CommandSource(sim, friend, addr, profile))
+    duration_us = int(duration_s * 1e6)
+    sim.run(duration_us)
+
+    total = LpnStats()
+    for lpn in lpns:
+        total.merge(lpn.stats)
+    sent = sum(source.sent for source in sources)
+    adv_event_us = 3 * (adv_airtime_us(POLL_PDU_LEN) + ADV_CHANNEL_SWITCH_US)
+    current = energy.average_current_ua(total, duration_us * len(lpns), adv_event_us)
+    result.update(feasible=True, friend_rssi=chosen["rssi"], current_ua=round(current, 2),
+                  latency_p50_ms=round(percentile(total.latency_us, 0.5) / 1000, 1),
+                  latency_p95_ms=round(percentile(total.latency_us, 0.95) / 1000, 1),
+                  loss=round(total.dropped / sent, 4) if sent else 0.0,
+                  battery_days=round(energy.battery_days(current), 1))
+    return result
+
+
+def pareto(results):
+    """Feasible results not dominated in all metrics by another result."""
+    feasible = [r for r in results if r["feasible"]]
+    front = []
+    for r in feasible:
+        dominated = any(all(o[m] <= r[m] for m in METRICS) and any(o[m] < r[m] for m in METRICS)
+                        for o in feasible if o is not r)
+        if not dominated:
+            front.append(r)
+    return sorted(front, key=lambda r: r["current_ua"])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--profile", help="traffic profile JSON file, default: built in profile")
+    parser.add_argument("--duration", type=float, default=4 * 3600, help="simulated time per combination in seconds")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--csv", help="write all results to the CSV file")
+    for name, _, default in PARAMETERS:
+        parser.add_argument("--" + name.replace("_", "-"), default=str(default), help="default: %(default)s")
+    args = parser.parse_args()
+
+    profile = TrafficProfile.load(args.profile) if args.profile else TrafficProfile()
+    names = [name for name, _, _ in PARAMETERS]
+    values = [[int(v) for v in getattr(args, name).split(",")] for name in names]
+    energy = EnergyModel()
+
+    results = []
+    for combination in itertools.product(*values):
+        results.append(evaluate(dict(zip(names, combination)), profile, args.duration, args.seed, energy))
+        print("\r%d combinations" % len(results), end="", file=sys.stderr)
+    print(file=sys.stderr)
+
+    columns = names + ["feasible", "friend_rssi", "current_ua", "battery_days", "latency_p50_ms", "latency_p95_ms", "loss"]
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=columns)
+            writer.writeheader()
+            writer.writerows(results)
+
+    infeasible = len([r for r in results if not r["feasible"]])
+    if infeasible:
+        print("%d combinations do not establish friendship (cache smaller than 2^min_cache_size_log)" % infeasible)
+    print("Pareto frontier (%s):" % ", ".join(METRICS))
+    print(" ".join("%s" % c for c in columns))
+    for r in pareto(results):
+        print(" ".join(str(r[c]) for c in columns))
+
+
+if __name__ == "__main__":
+    main()
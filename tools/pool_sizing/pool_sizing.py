@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+Buffer pool sizing from POOL_STATS records.
+
+Reads records of WICED HCI event 0xE08E (pool_stats.h) collected from low_power_led nodes,
+one record per line as hex bytes, and computes for each role, LPN or friend, the number of
+buffers each pool of wiced_bt_cfg needs: the highest maximum allocated seen on any node of
+the role plus a margin.  A pool which was exhausted on some node cannot show its real need,
+its size is raised by half and the nodes have to be measured again.  Prints the pool table
+with the RAM saved or added and a wiced_bt_cfg_buf_pools initializer for each role.
+
+    python3 pool_sizing.py records/friend.txt records/lpn.txt
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+ROLES = {0: "friend", 1: "lpn"}
+HEADER = struct.Struct("<BBI")
+POOL = struct.Struct("<HHHHIH")
+
+
+def parse_record(data):
+    """Returns (role, samples, pools), pools a list of dicts in pool order."""
+    role, num_pools, samples = HEADER.unpack_from(data, 0)
+    if role not in ROLES:
+        raise ValueError("unknown role %d" % role)
+    if len(data) < HEADER.size + num_pools * POOL.size:
+        raise ValueError("record too short for %d pools" % num_pools)
+    pools = []
+    for i in range(num_pools):
+        size, count, current, peak, exhausted, exhausted_at = POOL.unpack_from(data, HEADER.size + i * POOL.size)
+        pools.append(dict(size=size, count=count, current=current, peak=peak,
+                          exhausted=exhausted, exhausted_at=exhausted_at))
+    return ROLES[role], samples, pools
+
+
+def read_records(paths):
+    """Hex records, one per line, bytes optionally separated by spaces or colons, # comments."""
+    records = []
+    for path in paths:
+        with open(path) as f:
+            for lineno, line in enumerate(f, 1):
+                line = line.split("#", 1)[0].replace(":", "").replace(" ", "").strip()
+                if not line:
+                    continue
+                try:
+                    records.append(parse_record(bytes.fromhex(line)))
+                except ValueError as e:
+                    sys.exit("%s:%d: %s" % (path, lineno, e))
+    return records
+
+
+def size_pools(records, margin, min_margin):
+    """Returns {role: [pool]} with the configured and the recommended number of buffers."""
+    roles = {}
+    for role, samples, pools in records:
+        sized = roles.setdefault(role, [])
+        for i, pool in enumerate(pools):
+            if i == len(sized):
+                sized.append(dict(size=pool["size"], count=pool["count"], peak=0, exhausted=0,
+                                  nodes=0, exhausted_nodes=0))
+            entry = sized[i]
+            if entry["size"] != pool["size"] or entry["count"] != pool["count"]:
+                sys.exit("%s pool %d differs between records, collect one configuration per role" % (role, i))
+            entry["nodes"] += 1
+            entry["peak"] = max(entry["peak"], pool["peak"])
+            entry["exhausted"] += pool["exhausted"]
+            if pool["exhausted"] or pool["peak"] >= pool["count"]:
+                entry["exhausted_nodes"] += 1
+
+    for sized in roles.values():
+        for entry in sized:
+            if entry["exhausted_nodes"]:
+                entry["need"] = max(entry["count"] + (entry["count"] + 1) // 2,
+                                    entry["peak"] + min_margin)
+            else:
+                entry["need"] = entry["peak"] + max(min_margin, math.ceil(entry["peak"] * margin))
+    return roles
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="+", help="files with one POOL_STATS record per line")
+    parser.add_argument("--margin", type=float, default=0.25, help="margin above the highest peak, fraction of the peak")
+    parser.add_argument("--min-margin", type=int, default=2, help="minimum margin in buffers")
+    parser.add_argument("--overhead", type=int, default=8, help="bytes of buffer header per buffer")
+    args = parser.parse_args()
+
+    roles = size_pools(read_records(args.files), args.margin, args.min_margin)
+    for role in sorted(roles):
+        sized = roles[role]
+        print("%s, %d nodes" % (role, max(e["nodes"] for e in sized)))
+        print("  pool  size  count  peak  exhausted  need  ram bytes")
+        total = 0
+        for i, e in enumerate(sized):
+            ram = (e["need"] - e["count"]) * (e["size"] + args.overhead)
+            total += ram
+            note = "  measure again" if e["exhausted_nodes"] else ""
+            print("  %4d %5d %6d %5d %10d %5d %+10d%s" % (i, e["size"], e["count"], e["peak"], e["exhausted"],
+                                                      e["need"], ram, note))
+        print("  total %+d bytes" % total)
+        print("  const wiced_bt_cfg_buf_pool_t wiced_bt_cfg_buf_pools[WICED_BT_CFG_NUM_BUF_POOLS] =")
+        print("  {")
+        for e in sized:
+            print("      { %4d, %3d }," % (e["size"], e["need"]))
+        print("  };")
+        print()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Telemetry collector of low_power_led nodes.
+
+Reads the WICED HCI UART of one or more nodes, or a capture file, requests the statistics of
+the firmware every --interval seconds, decodes the events and appends them, tagged with the
+time, the site and the node, to an append-only column store.  site_report.py summarizes the
+store.
+
+    python3 collect.py --site office --port /dev/ttyUSB0=lpn-12 --port /dev/ttyUSB1=friend-3
+    python3 collect.py --site office --capture lpn-12.cap --node lpn-12
+"""
+
+import argparse
+import os
+import select
+import sys
+import time
+
+from telemetry import hci, port, records
+from telemetry.store import ColumnStore
+
+
+class Collector:
+    def __init__(self, store, site):
+        self.store = store
+        self.site = site
+        self.pending = {}
+        self.counts = {}
+
+    def packet(self, node, opcode, payload, when):
+        table, rows = records.decode(opcode, payload)
+        for row in rows:
+            tagged = dict(time=float(when), site=self.site, node=node)
+            tagged.update(row)
+            self.pending.setdefault(table, []).append(tagged)
+            self.counts[table] = self.counts.get(table, 0) + 1
+
+    def flush(self):
+        for table, rows in self.pending.items():
+            self.store.append(table, rows)
+        self.pending = {}
+
+
+def read_capture(path, node, collector):
+    """Text captures written by --record ('<unix time> <hex packet> [node]' per line), or the raw
+    UART bytes, which are timestamped with the modification time of the file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    parsers = {}
+    if data[:1] == bytes([hci.HCI_WICED_PKT]):
+        parser = parsers.setdefault(node, hci.Parser())
+        for opcode, payload in parser.feed(data):
+            collector.packet(node, opcode, payload, os.path.getmtime(path))
+    else:
+        for lineno, line in enumerate(data.decode().splitlines(), 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            try:
+                when, packet = float(fields[0]), bytes.fromhex(fields[1])
+            except (ValueError, IndexError):
+                sys.exit("%s:%d: expected time and hex packet" % (path, lineno))
+            line_node = fields[2] if len(fields) > 2 else node
+            parser = parsers.setdefault(line_node, hci.Parser())
+            for opcode, payload in parser.feed(packet):
+                collector.packet(line_node, opcode, payload, when)
+    collector.flush()
+    return sum(p.skipped for p in parsers.values())
+
+
+def run_ports(ports, args, collector):
+    nodes = {}
+    for spec in ports:
+        path, _, node = spec.partition("=")
+        fd = port.open_serial(path, args.baud)
+        nodes[fd] = dict(node=node or os.path.basename(path), parser=hci.Parser(), path=path)
+    record = open(args.record, "a") if args.record else None
+    commands = [hci.encode(hci.COMMANDS[name]) for name in args.stats.split(",")]
+    end = time.time() + args.duration if args.duration else None
+    next_poll = time.time()
+    try:
+        while end is None or time.time() < end:
+            now = time.time()
+            if now >= next_poll:
+                collector.flush()
+                for fd in nodes:
+                    for command in commands:
+                        port.write_all(fd, command)
+                next_poll += args.interval
+            timeout = max(min(next_poll, end or next_poll) - time.time(), 0)
+            readable, _, _ = select.select(list(nodes), [], [], timeout)
+            for fd in readable:
+                try:
+                    data = os.read(fd, 4096)
+                except BlockingIOError:
+                    continue
+                when = time.time()
+                for opcode, payload in nodes[fd]["parser"].feed(data):
+                    if record:
+                        record.write("%.3f %s %s\n" % (when, hci.encode(opcode, payload).hex(), nodes[fd]["node"]))
+                    collector.packet(nodes[fd]["node"], opcode, payload, when)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        collector.flush()
+        if record:
+            record.close()
+        for fd in nodes:
+            os.close(fd)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--store", default="telemetry.wtc", help="column store file (default telemetry.wtc)")
+    parser.add_argument("--site", default="site", help="site name stored with every row")
+    parser.add_argument("--port", action="append", default=[], help="UART device, optionally =node name; repeat for more nodes")
+    parser.add_argument("--baud", type=int, default=3000000, help="UART baud rate (default 3000000)")
+    parser.add_argument("--capture", action="append", default=[], help="capture file to import instead of a UART")
+    parser.add_argument("--node", help="node name of raw captures and of lines without one (default: file name)")
+    parser.add_argument("--stats", default="lpn,friend,cohort",
+                        help="statistics to request, of %s (default lpn,friend,cohort)" % ",".join(sorted(hci.COMMANDS)))
+    parser.add_argument("--interval", type=float, default=300.0, help="seconds between requests (default 300)")
+    parser.add_argument("--duration", type=float, default=0.0, help="seconds to collect, 0 until interrupted")
+    parser.add_argument("--record", help="append received packets to this capture file")
+    args = parser.parse_args()
+
+    if bool(args.port) == bool(args.capture):
+        parser.error("give either --port or --capture")
+    unknown = set(args.stats.split(",")) - set(hci.COMMANDS)
+    if unknown:
+        parser.error("unknown statistics %s" % ",".join(sorted(unknown)))
+
+    collector = Collector(ColumnStore(args.store), args.site)
+    if args.capture:
+        for path in args.capture:
+            skipped = read_capture(path, args.node or os.path.splitext(os.path.basename(path))[0], collector)
+            if skipped:
+                print("%s: %d bytes outside WICED HCI packets" % (path, skipped))
+    else:
+        run_ports(args.port, args, collector)
+    print("stored %s" % (", ".join("%d %s rows" % (n, t) for t, n in sorted(collector.counts.items())) or "nothing"))
+
+
+if __name__ == "__main__":
+    main()
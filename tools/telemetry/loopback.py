@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""
+Loopback stand-ins for low_power_led nodes.
+
+Creates one pseudo terminal per simulated node and answers the WICED HCI statistics commands
+on it like the firmware, so that collect.py can be run and tested without hardware.  Time
+on the nodes runs --speed times faster than on the host.
+
+    python3 loopback.py --lpns 3 --friends 1 --dir /tmp
+    python3 collect.py --site lab --port /tmp/lpn0 --port /tmp/lpn1 --port /tmp/lpn2 --port /tmp/friend0 --interval 5
+"""
+
+import argparse
+import os
+import select
+import time
+
+from telemetry import hci, port
+from telemetry.device import make_device
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--lpns", type=int, default=2, help="low power nodes (default 2)")
+    parser.add_argument("--friends", type=int, default=1, help="friend nodes (default 1)")
+    parser.add_argument("--dir", default="/tmp", help="directory of the device links lpn0, lpn1, ..., friend0, ... (default /tmp)")
+    parser.add_argument("--speed", type=float, default=60.0, help="node seconds per host second (default 60)")
+    parser.add_argument("--poll-interval", type=float, default=10.0, help="LPN poll interval in seconds (default 10)")
+    parser.add_argument("--no-early-sleep", type=int, default=0, help="LPNs, from the last one, scanning the whole receive window")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    start = time.time()
+    clock = lambda: start + (time.time() - start) * args.speed
+    devices = {}
+    for role, count in (("lpn", args.lpns), ("friend", args.friends)):
+        for i in range(count):
+            if role == "lpn":
+                kwargs = dict(poll_interval=args.poll_interval, early_sleep=i < args.lpns - args.no_early_sleep,
+                              cohort=0 if i < args.lpns - args.no_early_sleep else 1)
+            else:
+                kwargs = dict(poll_interval=args.poll_interval, first_lpn=0x0100 + 0x20 * i)
+            master, slave, path = port.open_pty(os.path.join(args.dir, "%s%d" % (role, i)))
+            devices[master] = dict(device=make_device(role, args.seed * 100 + len(devices), clock(), **kwargs),
+                                   parser=hci.Parser(), slave=slave)
+            print("%s %d on %s" % (role, i, path))
+
+    try:
+        while True:
+            readable, _, _ = select.select(list(devices), [], [])
+            for fd in readable:
+                try:
+                    data = os.read(fd, 4096)
+                except OSError:
+                    continue
+                entry = devices[fd]
+                for opcode, payload in entry["parser"].feed(data):
+                    for event, record in entry["device"].handle(opcode, payload, clock()):
+                        port.write_all(fd, hci.encode(event, record))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
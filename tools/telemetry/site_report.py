@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+Per node and per site report of the telemetry collected by collect.py.
+
+For each low power node: sleep residency, mean poll interval, awake time per poll, average
+current and battery life with the energy model of tools/mesh_sim.  For each friend node and
+LPN: messages enqueued, delivered and lost, missed polls and the delivery latency from the
+friend_stats histogram.  For each site the same figures over all its nodes.
+
+    python3 site_report.py --store telemetry.wtc --hours 24
+"""
+
+import argparse
+import sys
+import time
+
+from telemetry import report
+from telemetry.store import ColumnStore
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--store", default="telemetry.wtc", help="column store file (default telemetry.wtc)")
+    parser.add_argument("--site", action="append", help="report only these sites")
+    parser.add_argument("--hours", type=float, help="report only the last hours of samples")
+    parser.add_argument("--csv", help="write the low power node figures to this CSV file")
+    args = parser.parse_args()
+
+    store = ColumnStore(args.store)
+    damaged = store.damaged_bytes()
+    if damaged:
+        print("%d bytes at the end of %s are not a complete block, ignored" % (damaged, args.store))
+    since = time.time() - args.hours * 3600 if args.hours else None
+    lpns = report.lpn_nodes(store, report.energy_model(), since)
+    links = report.friend_links(store, since)
+    if args.site:
+        lpns = [e for e in lpns if e["site"] in args.site]
+        links = [l for l in links if l["site"] in args.site]
+    if not lpns and not links:
+        sys.exit("no node sampled at two different times in %s" % args.store)
+
+    report.print_nodes(lpns, links, sys.stdout)
+    report.print_sites(lpns, links, sys.stdout)
+    if args.csv:
+        report.write_csv(lpns, args.csv)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,8 @@
+"""
+Host side telemetry collector of the low_power_led application.
+
+The statistics of the firmware are read over WICED HCI, decoded with the record layouts of
+the firmware headers, kept in an append-only column store and summarized per node and per
+site.  The device module stands in for a node on a pseudo terminal, so the collector can be
+run without hardware.
+"""
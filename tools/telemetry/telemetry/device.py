@@ -0,0 +1,118 @@
+"""
+Stand-in for a low_power_led node on the WICED HCI UART.
+
+A low power node or a friend node is simulated in host time, optionally sped up, and answers
+the statistics commands of low_power_led_hci.h with records in the firmware layout.  The
+numbers are plausible, not a model of the mesh; tools/mesh_sim is the simulator.
+"""
+
+import bisect
+import math
+import random
+
+from . import hci, records
+
+
+class LpnDevice:
+    role = "lpn"
+
+    def __init__(self, rng, now, poll_interval=10.0, receive_delay=100, messages_per_hour=4.0,
+                 early_sleep=True, experiment=1, cohort=0):
+        self.rng = rng
+        self.poll_interval = poll_interval
+        self.receive_delay = receive_delay
+        self.message_probability = min(messages_per_hour * poll_interval / 3600.0, 1.0)
+        self.early_sleep = early_sleep
+        self.time = now
+        self.power = dict.fromkeys(records.LPN_POWER_FIELDS, 0)
+        self.idle_awake_us = 0
+        self.other_awake_us = 0
+        self.cohort = dict.fromkeys(records.COHORT_FIELDS, 0)
+        self.cohort.update(experiment=experiment, cohort=cohort, early_sleep=int(early_sleep),
+                           poll_timeout=int(poll_interval * 10), receive_delay=receive_delay)
+
+    def advance(self, now):
+        while self.time + self.poll_interval <= now:
+            self.time += self.poll_interval
+            if self.rng.random() < self.message_probability:
+                awake_us = int(self.rng.gauss(45000, 5000))
+                self.power["other_polls"] += 1
+                self.other_awake_us += awake_us
+                self.cohort["messages"] += 1
+            else:
+                # Early sleep closes the receive window at the Friend Update
+                awake_us = int(self.rng.gauss(13000, 1200) if self.early_sleep else self.rng.gauss(self.receive_delay * 1000 + 12000, 1500))
+                self.power["idle_polls"] += 1
+                self.idle_awake_us += awake_us
+                self.power["idle_awake_max_us"] = max(self.power["idle_awake_max_us"], awake_us)
+                self.power["early_sleeps"] += int(self.early_sleep)
+            self.cohort["cycles"] += 1
+            self.cohort["awake_10us"] += awake_us // 10
+            self.cohort["sleep_ms"] += int(self.poll_interval * 1000 - awake_us / 1000)
+            # Regular polls, a message waits half the interval
+            self.cohort["latency_mean_ms"] = int(self.poll_interval * 500) + self.receive_delay
+            self.cohort["latency_max_ms"] = int(self.poll_interval * 1000) + self.receive_delay
+        self.power["idle_awake_ms"] = self.idle_awake_us // 1000
+        self.power["other_awake_ms"] = self.other_awake_us // 1000
+        self.power["idle_awake_avg_us"] = self.idle_awake_us // self.power["idle_polls"] if self.power["idle_polls"] else 0
+
+    def handle(self, opcode, payload, now):
+        self.advance(now)
+        if opcode == hci.COMMAND_LPN_POWER_STATS_GET:
+            return [(hci.EVENT_LPN_POWER_STATS, records.LPN_POWER.pack(*(self.power[f] for f in records.LPN_POWER_FIELDS)))]
+        if opcode == hci.COMMAND_COHORT_STATS_GET:
+            return [(hci.EVENT_COHORT_STATS, records.encode_cohort(self.cohort))]
+        return []
+
+
+class FriendDevice:
+    role = "friend"
+
+    def __init__(self, rng, now, lpns=2, poll_interval=10.0, messages_per_hour=20.0, first_lpn=0x0100):
+        self.rng = rng
+        self.poll_interval = poll_interval
+        self.rate = messages_per_hour / 3600.0
+        self.time = now
+        self.lpns = []
+        for i in range(lpns):
+            entry = dict.fromkeys(records.FRIEND_FIELDS, 0)
+            entry.update(lpn=first_lpn + 2 * i, established=1, friendships=1)
+            self.lpns.append(entry)
+
+    def advance(self, now):
+        elapsed, self.time = now - self.time, now
+        for entry in self.lpns:
+            for _ in range(self._poisson(self.rate * elapsed)):
+                entry["enqueued"] += 1
+                if self.rng.random() < 0.01:
+                    # Friend cache full, oldest message dropped
+                    entry["overflows"] += 1
+                    entry["evictions"] += 1
+                    continue
+                latency = self.rng.uniform(0, self.poll_interval) + self.rng.expovariate(10.0)
+                entry["delivered"] += 1
+                entry["latency_sum_ms"] += int(latency * 1000)
+                entry["latency_max_ms"] = max(entry["latency_max_ms"], int(latency * 1000))
+                bucket = bisect.bisect_left(records.FRIEND_LATENCY_LIMITS, latency)
+                entry["latency_%d" % bucket] = min(entry["latency_%d" % bucket] + 1, 0xFFFF)
+            entry["missed_polls"] += self._poisson(0.002 * elapsed / self.poll_interval)
+
+    def _poisson(self, mean):
+        if mean > 50:
+            return max(int(round(self.rng.gauss(mean, mean ** 0.5))), 0)
+        count, limit, product = 0, math.exp(-mean), self.rng.random()
+        while product > limit:
+            count += 1
+            product *= self.rng.random()
+        return count
+
+    def handle(self, opcode, payload, now):
+        self.advance(now)
+        if opcode == hci.COMMAND_FRIEND_STATS_GET:
+            return [(hci.EVENT_FRIEND_STATS, records.FRIEND.pack(*(e[f] for f in records.FRIEND_FIELDS))) for e in self.lpns]
+        return []
+
+
+def make_device(role, seed, now, **kwargs):
+    rng = random.Random(seed)
+    return LpnDevice(rng, now, **kwargs) if role == "lpn" else FriendDevice(rng, now, **kwargs)
@@ -0,0 +1,72 @@
+"""
+WICED HCI UART framing and the opcodes of low_power_led_hci.h.
+
+Every packet in both directions is 0x19, opcode (2 bytes), payload length (2 bytes), payload,
+little endian.  Traces and events of mesh_app_lib share the UART with the application events.
+"""
+
+import struct
+
+HCI_WICED_PKT = 0x19
+HEADER = struct.Struct("<BHH")
+MAX_PAYLOAD = 1024
+
+GROUP_LOW_POWER_LED = 0xE0
+
+COMMAND_FRIEND_STATS_GET = (GROUP_LOW_POWER_LED << 8) | 0x01
+COMMAND_LPN_POWER_STATS_GET = (GROUP_LOW_POWER_LED << 8) | 0x03
+COMMAND_NVRAM_STATS_GET = (GROUP_LOW_POWER_LED << 8) | 0x05
+COMMAND_POOL_STATS_GET = (GROUP_LOW_POWER_LED << 8) | 0x14
+COMMAND_COHORT_STATS_GET = (GROUP_LOW_POWER_LED << 8) | 0x16
+
+EVENT_FRIEND_STATS = (GROUP_LOW_POWER_LED << 8) | 0x81
+EVENT_LPN_POWER_STATS = (GROUP_LOW_POWER_LED << 8) | 0x82
+EVENT_NVRAM_STATS = (GROUP_LOW_POWER_LED << 8) | 0x83
+EVENT_POOL_STATS = (GROUP_LOW_POWER_LED << 8) | 0x8E
+EVENT_COHORT_STATS = (GROUP_LOW_POWER_LED << 8) | 0x8F
+
+# Statistics the collector requests, by name
+COMMANDS = {
+    "friend": COMMAND_FRIEND_STATS_GET,
+    "lpn": COMMAND_LPN_POWER_STATS_GET,
+    "cohort": COMMAND_COHORT_STATS_GET,
+    "pool": COMMAND_POOL_STATS_GET,
+}
+
+
+def encode(opcode, payload=b""):
+    return HEADER.pack(HCI_WICED_PKT, opcode, len(payload)) + bytes(payload)
+
+
+class Parser:
+    """Splits a byte stream into (opcode, payload) packets, skipping bytes which do not start a packet."""
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.skipped = 0
+
+    def feed(self, data):
+        self.buffer += data
+        packets = []
+        while True:
+            start = self.buffer.find(HCI_WICED_PKT)
+            if start < 0:
+                self.skipped += len(self.buffer)
+                del self.buffer[:]
+                break
+            if start:
+                self.skipped += start
+                del self.buffer[:start]
+            if len(self.buffer) < HEADER.size:
+                break
+            _, opcode, length = HEADER.unpack_from(self.buffer)
+            if length > MAX_PAYLOAD:
+                # Not a packet header, look for the next one
+                self.skipped += 1
+                del self.buffer[:1]
+                continue
+            if len(self.buffer) < HEADER.size + length:
+                break
+            packets.append((opcode, bytes(self.buffer[HEADER.size:HEADER.size + length])))
+            del self.buffer[:HEADER.size + length]
+        return packets
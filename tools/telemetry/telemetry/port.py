@@ -0,0 +1,47 @@
+"""
+Serial ports and pseudo terminals on Linux, with termios only.
+"""
+
+import os
+import termios
+import tty
+
+
+def open_serial(path, baud):
+    """Opens the UART raw, 8N1, without flow control. Returns the file descriptor."""
+    speed = getattr(termios, "B%d" % baud, None)
+    if speed is None:
+        raise ValueError("baud rate %d not supported" % baud)
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[2] &= ~(termios.CSTOPB | termios.PARENB | termios.CRTSCTS)
+    attrs[2] |= termios.CLOCAL | termios.CREAD
+    attrs[4] = attrs[5] = speed
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+def open_pty(link=None):
+    """Opens a pseudo terminal. Returns (master fd, path of the device end), the path is
+    linked from link if given."""
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    path = os.ttyname(slave)
+    if link:
+        if os.path.lexists(link):
+            os.unlink(link)
+        os.symlink(path, link)
+        path = link
+    # The device end stays open so that the master does not see a hang up between collectors
+    return master, slave, path
+
+
+def write_all(fd, data):
+    while data:
+        try:
+            written = os.write(fd, data)
+        except BlockingIOError:
+            continue
+        data = data[written:]
@@ -0,0 +1,87 @@
+"""
+Record layouts of the WICED HCI events, as described in friend_stats.h, lpn_power_stats.h,
+cohort.h and pool_stats.h.  Each event is decoded into one row of a table, a dict of ints.
+"""
+
+import struct
+
+from . import hci
+
+FRIEND_LATENCY_BUCKETS = 8
+# Upper limits of the friend_stats latency buckets in seconds, the last bucket is unbounded
+FRIEND_LATENCY_LIMITS = (0.5, 1, 2, 5, 10, 20, 60, float("inf"))
+
+FRIEND = struct.Struct("<HBHH7I%dH" % FRIEND_LATENCY_BUCKETS)
+FRIEND_FIELDS = ("lpn", "established", "friendships", "terminations", "enqueued", "delivered",
+                 "overflows", "evictions", "missed_polls", "latency_sum_ms", "latency_max_ms") + \
+    tuple("latency_%d" % i for i in range(FRIEND_LATENCY_BUCKETS))
+
+LPN_POWER = struct.Struct("<7I")
+LPN_POWER_FIELDS = ("idle_polls", "idle_awake_ms", "idle_awake_avg_us", "idle_awake_max_us",
+                    "other_polls", "other_awake_ms", "early_sleeps")
+
+COHORT_HEADER = struct.Struct("<HBBB")
+COHORT_STATS = struct.Struct("<BBIIIIII")
+COHORT_LEN = COHORT_HEADER.size + 3 + COHORT_STATS.size
+COHORT_FIELDS = ("experiment", "cohort", "source", "early_sleep", "poll_timeout", "transmit_count",
+                 "receive_delay", "cycles", "awake_10us", "sleep_ms", "messages", "latency_mean_ms",
+                 "latency_max_ms")
+
+POOL_HEADER = struct.Struct("<BBI")
+POOL = struct.Struct("<HHHHIH")
+POOL_FIELDS = ("size", "count", "current", "peak", "exhausted", "exhausted_at")
+
+
+def decode_friend(payload):
+    return [dict(zip(FRIEND_FIELDS, FRIEND.unpack_from(payload)))]
+
+
+def decode_lpn_power(payload):
+    return [dict(zip(LPN_POWER_FIELDS, LPN_POWER.unpack_from(payload)))]
+
+
+def decode_cohort(payload):
+    if len(payload) < COHORT_LEN:
+        raise struct.error("cohort record too short")
+    experiment, cohort, source, early_sleep = COHORT_HEADER.unpack_from(payload)
+    poll_timeout = int.from_bytes(payload[COHORT_HEADER.size:COHORT_HEADER.size + 3], "little")
+    stats = COHORT_STATS.unpack_from(payload, COHORT_HEADER.size + 3)
+    return [dict(zip(COHORT_FIELDS, (experiment, cohort, source, early_sleep, poll_timeout) + stats))]
+
+
+def encode_cohort(row):
+    return (COHORT_HEADER.pack(*(row[f] for f in COHORT_FIELDS[:4])) + row["poll_timeout"].to_bytes(3, "little")
+            + COHORT_STATS.pack(*(row[f] for f in COHORT_FIELDS[5:])))
+
+
+def decode_pool(payload):
+    """One row per pool"""
+    role, num_pools, samples = POOL_HEADER.unpack_from(payload)
+    rows = []
+    for i in range(num_pools):
+        row = dict(zip(POOL_FIELDS, POOL.unpack_from(payload, POOL_HEADER.size + i * POOL.size)))
+        row.update(role=role, pool=i, samples=samples)
+        rows.append(row)
+    return rows
+
+
+DECODERS = {
+    hci.EVENT_FRIEND_STATS: ("friend", decode_friend),
+    hci.EVENT_LPN_POWER_STATS: ("lpn_power", decode_lpn_power),
+    hci.EVENT_COHORT_STATS: ("cohort", decode_cohort),
+    hci.EVENT_POOL_STATS: ("pool", decode_pool),
+}
+
+
+def decode(opcode, payload):
+    """Returns (table, rows).  Other events of the application go to the events table with the
+    payload as hex, other packets (traces, mesh_app_lib events) return (None, [])."""
+    if opcode in DECODERS:
+        table, decoder = DECODERS[opcode]
+        try:
+            return table, decoder(payload)
+        except struct.error:
+            pass
+    if (opcode >> 8) == hci.GROUP_LOW_POWER_LED:
+        return "events", [dict(opcode=opcode, payload=payload.hex())]
+    return None, []
@@ -0,0 +1,180 @@
+"""
+Per node and per site reports from the column store.
+
+The firmware counters are cumulative since boot or the last reset command.  The increase over
+the report period is the sum of the increases between consecutive samples of a node; a
+counter lower than in the previous sample restarted from 0, its value is the increase.
+"""
+
+import collections
+import os
+import sys
+
+from . import records
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "mesh_sim"))
+from mesh_sim.energy import EnergyModel  # noqa: E402
+
+
+def increase(values):
+    total = 0
+    for prev, cur in zip(values, values[1:]):
+        total += cur - prev if cur >= prev else cur
+    return total
+
+
+def _groups(rows, key):
+    groups = collections.defaultdict(list)
+    for row in sorted(rows, key=lambda r: r["time"]):
+        groups[key(row)].append(row)
+    return groups
+
+
+def _window(rows, since, until):
+    return [r for r in rows if (since is None or r["time"] >= since) and (until is None or r["time"] <= until)]
+
+
+def lpn_current_ua(model, awake_s, elapsed_s, polls):
+    """Awake time at the receive current, the rest in ePDS, a wake up overhead per poll cycle"""
+    sleep_s = max(elapsed_s - awake_s, 0.0)
+    charge = awake_s * model.rx_ua + sleep_s * model.sleep_ua + polls * model.wake_us * 1e-6 * model.active_ua
+    return charge / elapsed_s
+
+
+def lpn_nodes(store, model, since=None, until=None):
+    """One dict per LPN. Cohort records measure the sleep time on the node and cover HID-off,
+    they are used when present, otherwise the power statistics over the host time."""
+    result = {}
+    for (site, node), rows in _groups(_window(store.rows("cohort"), since, until), lambda r: (r["site"], r["node"])).items():
+        if len(rows) < 2:
+            continue
+        col = lambda name: [r[name] for r in rows]
+        polls = increase(col("cycles"))
+        awake = increase(col("awake_10us")) / 1e5
+        elapsed = awake + increase(col("sleep_ms")) / 1000.0
+        if elapsed <= 0 or polls == 0:
+            continue
+        result[(site, node)] = dict(site=site, node=node, source="cohort", hours=elapsed / 3600.0, polls=polls,
+                                    awake_s=awake, elapsed_s=elapsed)
+    for (site, node), rows in _groups(_window(store.rows("lpn_power"), since, until), lambda r: (r["site"], r["node"])).items():
+        if len(rows) < 2 or (site, node) in result:
+            continue
+        col = lambda name: [r[name] for r in rows]
+        elapsed = rows[-1]["time"] - rows[0]["time"]
+        polls = increase(col("idle_polls")) + increase(col("other_polls"))
+        if elapsed <= 0 or polls == 0:
+            continue
+        awake = (increase(col("idle_awake_ms")) + increase(col("other_awake_ms"))) / 1000.0
+        if awake > elapsed:
+            # Node clock faster than the host clock, a loopback node with --speed
+            sys.stderr.write("%s %s: awake longer than the %.0f s between samples, left out\n" % (site, node, elapsed))
+            continue
+        result[(site, node)] = dict(site=site, node=node, source="lpn", hours=elapsed / 3600.0, polls=polls,
+                                    awake_s=awake, elapsed_s=elapsed)
+    for entry in result.values():
+        entry["residency"] = 1.0 - entry["awake_s"] / entry["elapsed_s"]
+        entry["interval_s"] = entry["elapsed_s"] / entry["polls"]
+        entry["current_ua"] = lpn_current_ua(model, entry["awake_s"], entry["elapsed_s"], entry["polls"])
+        entry["battery_days"] = model.battery_days(entry["current_ua"])
+    return sorted(result.values(), key=lambda e: (e["site"], e["node"]))
+
+
+def friend_links(store, since=None, until=None):
+    """One dict per friend node and LPN address"""
+    links = []
+    buckets = ["latency_%d" % i for i in range(records.FRIEND_LATENCY_BUCKETS)]
+    for (site, node, lpn), rows in _groups(_window(store.rows("friend"), since, until),
+                                           lambda r: (r["site"], r["node"], r["lpn"])).items():
+        if len(rows) < 2:
+            continue
+        col = lambda name: [r[name] for r in rows]
+        link = dict(site=site, node=node, lpn=lpn, latency_max_ms=max(col("latency_max_ms")))
+        for name in ("enqueued", "delivered", "overflows", "evictions", "missed_polls", "latency_sum_ms"):
+            link[name] = increase(col(name))
+        link["histogram"] = [increase(col(b)) for b in buckets]
+        links.append(link)
+    return sorted(links, key=lambda l: (l["site"], l["node"], l["lpn"]))
+
+
+def percentile(histogram, fraction):
+    """Upper limit of the bucket holding the fraction of the deliveries, in seconds"""
+    total = sum(histogram)
+    if not total:
+        return None
+    cumulative = 0
+    for count, limit in zip(histogram, records.FRIEND_LATENCY_LIMITS):
+        cumulative += count
+        if cumulative >= fraction * total:
+            return limit
+    return records.FRIEND_LATENCY_LIMITS[-1]
+
+
+def _limit(value):
+    if value is None:
+        return "-"
+    return ">60" if value == float("inf") else "<=%g" % value
+
+
+def _mean(values):
+    return sum(values) / len(values) if values else 0.0
+
+
+def print_nodes(lpns, links, out):
+    if lpns:
+        out.write("Low power nodes\n")
+        out.write("%-10s %-14s %-6s %7s %8s %9s %10s %9s %8s %8s\n" % (
+            "site", "node", "source", "hours", "polls", "sleep %", "interval s", "awake ms", "uA", "days"))
+        for e in lpns:
+            awake_ms = e["awake_s"] * 1000.0 / e["polls"]
+            out.write("%-10s %-14s %-6s %7.1f %8d %9.3f %10.2f %9.2f %8.2f %8.0f\n" % (
+                e["site"], e["node"], e["source"], e["hours"], e["polls"], e["residency"] * 100, e["interval_s"],
+                awake_ms, e["current_ua"], e["battery_days"]))
+    if links:
+        out.write("\nFriend nodes\n")
+        out.write("%-10s %-14s %6s %8s %9s %9s %7s %8s %8s %8s %8s\n" % (
+            "site", "node", "lpn", "enqueued", "delivered", "overflows", "missed", "mean s", "p50 s", "p90 s", "max s"))
+        for l in links:
+            mean = l["latency_sum_ms"] / 1000.0 / l["delivered"] if l["delivered"] else 0.0
+            out.write("%-10s %-14s 0x%04x %8d %9d %9d %7d %8.2f %8s %8s %8.2f\n" % (
+                l["site"], l["node"], l["lpn"], l["enqueued"], l["delivered"], l["overflows"], l["missed_polls"],
+                mean, _limit(percentile(l["histogram"], 0.5)), _limit(percentile(l["histogram"], 0.9)),
+                l["latency_max_ms"] / 1000.0))
+
+
+def print_sites(lpns, links, out):
+    sites = sorted({e["site"] for e in lpns} | {l["site"] for l in links})
+    for site in sites:
+        nodes = [e for e in lpns if e["site"] == site]
+        site_links = [l for l in links if l["site"] == site]
+        out.write("\nSite %s\n" % site)
+        if nodes:
+            residency = [e["residency"] for e in nodes]
+            days = sorted(e["battery_days"] for e in nodes)
+            worst = min(nodes, key=lambda e: e["battery_days"])
+            out.write("  low power nodes %d, sleep %.3f%% mean, %.3f%% lowest\n" % (
+                len(nodes), _mean(residency) * 100, min(residency) * 100))
+            out.write("  average current %.2f uA mean, battery %.0f days median, %.0f days shortest (%s)\n" % (
+                _mean([e["current_ua"] for e in nodes]), days[len(days) // 2], days[0], worst["node"]))
+        if site_links:
+            histogram = [sum(h) for h in zip(*(l["histogram"] for l in site_links))]
+            enqueued = sum(l["enqueued"] for l in site_links)
+            delivered = sum(l["delivered"] for l in site_links)
+            out.write("  friend links %d, delivered %d of %d messages (%.2f%%), %d overflows, %d missed polls\n" % (
+                len(site_links), delivered, enqueued, 100.0 * delivered / enqueued if enqueued else 100.0,
+                sum(l["overflows"] for l in site_links), sum(l["missed_polls"] for l in site_links)))
+            out.write("  latency p50 %s s, p90 %s s, p99 %s s\n" % (
+                _limit(percentile(histogram, 0.5)), _limit(percentile(histogram, 0.9)), _limit(percentile(histogram, 0.99))))
+            out.write("  latency histogram %s\n" % "  ".join(
+                "%s:%d" % (_limit(limit), count) for limit, count in zip(records.FRIEND_LATENCY_LIMITS, histogram)))
+
+
+def write_csv(lpns, path):
+    fields = ("site", "node", "source", "hours", "polls", "residency", "interval_s", "awake_s", "current_ua", "battery_days")
+    with open(path, "w") as f:
+        f.write(",".join(fields) + "\n")
+        for e in lpns:
+            f.write(",".join(str(e[name]) for name in fields) + "\n")
+
+
+def energy_model():
+    return EnergyModel()
@@ -0,0 +1,166 @@
+"""
+Append-only column store.
+
+The file is a sequence of blocks.  A block holds rows of one table, column by column:
+
+    magic "WTCB", payload length (4), CRC-32 of the payload (4), payload
+    payload: table name, rows (4), columns (2), then for each column its name, type and data
+    name: length (1) and UTF-8 bytes
+    type: 'q' 64 bit integers, 'd' doubles, 's' strings as length (2) and UTF-8 bytes
+    data: length (4) and the values of all rows
+
+Rows are only ever added with a new block at the end of the file, written with one write
+call.  A block torn by a crash or a full disk fails its CRC; it is cut off when the file is
+opened for writing and ignored when reading.  A reader decodes only the columns it asks for.
+"""
+
+import array
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"WTCB"
+BLOCK = struct.Struct("<4sII")
+COUNTS = struct.Struct("<IH")
+
+if sys.byteorder != "little":
+    raise ImportError("the column store is written little endian")
+
+
+def _name(data, offset):
+    length = data[offset]
+    return data[offset + 1:offset + 1 + length].decode(), offset + 1 + length
+
+
+def _encode_name(name):
+    raw = name.encode()
+    return bytes([len(raw)]) + raw
+
+
+def _column_type(value):
+    if isinstance(value, bool) or isinstance(value, int):
+        return "q"
+    if isinstance(value, float):
+        return "d"
+    return "s"
+
+
+def _encode_column(kind, values):
+    if kind in "qd":
+        return array.array(kind, values).tobytes()
+    out = bytearray()
+    for v in values:
+        raw = str(v).encode()
+        out += struct.pack("<H", len(raw)) + raw
+    return bytes(out)
+
+
+def _decode_column(kind, data, rows):
+    if kind in "qd":
+        values = array.array(kind)
+        values.frombytes(data)
+        return values.tolist()
+    values, offset = [], 0
+    for _ in range(rows):
+        (length,) = struct.unpack_from("<H", data, offset)
+        values.append(data[offset + 2:offset + 2 + length].decode())
+        offset += 2 + length
+    return values
+
+
+class ColumnStore:
+    def __init__(self, path):
+        self.path = path
+        self.checked = False
+
+    def _blocks(self):
+        """Yields (offset, payload) of the valid blocks, and sets self.valid_end."""
+        self.valid_end = 0
+        if not os.path.exists(self.path):
+            return
+        with open(self.path, "rb") as f:
+            while True:
+                header = f.read(BLOCK.size)
+                if len(header) < BLOCK.size:
+                    return
+                magic, length, crc = BLOCK.unpack(header)
+                if magic != MAGIC:
+                    return
+                payload = f.read(length)
+                if len(payload) < length or zlib.crc32(payload) != crc:
+                    return
+                offset = self.valid_end
+                self.valid_end += BLOCK.size + length
+                yield offset, payload
+
+    def damaged_bytes(self):
+        """Bytes after the last valid block"""
+        for _ in self._blocks():
+            pass
+        return os.path.getsize(self.path) - self.valid_end if os.path.exists(self.path) else 0
+
+    def append(self, table, rows):
+        """Append rows, dicts with the same keys, as one block. Column types come from the first row."""
+        if not rows:
+            return
+        names = list(rows[0])
+        payload = bytearray(_encode_name(table) + COUNTS.pack(len(rows), len(names)))
+        for name in names:
+            kind = _column_type(rows[0][name])
+            data = _encode_column(kind, [row[name] for row in rows])
+            payload += _encode_name(name) + kind.encode() + struct.pack("<I", len(data)) + data
+        block = BLOCK.pack(MAGIC, len(payload), zlib.crc32(payload)) + payload
+
+        # The tail is checked once, this process writes whole blocks
+        damaged = 0 if self.checked else self.damaged_bytes()
+        self.checked = True
+        fd = os.open(self.path, os.O_WRONLY | os.O_CREAT | os.O_APPEND, 0o644)
+        try:
+            if damaged:
+                os.ftruncate(fd, self.valid_end)
+            os.write(fd, block)
+            os.fsync(fd)
+        finally:
+            os.close(fd)
+
+    def tables(self):
+        names = set()
+        for _, payload in self._blocks():
+            names.add(_name(payload, 0)[0])
+        return sorted(names)
+
+    def read(self, table, columns=None):
+        """Returns {column: [values]} of all blocks of the table. Columns missing in a block are None."""
+        result = {}
+        total = 0
+        for _, payload in self._blocks():
+            name, offset = _name(payload, 0)
+            if name != table:
+                continue
+            rows, num_columns = COUNTS.unpack_from(payload, offset)
+            offset += COUNTS.size
+            seen = set()
+            for _ in range(num_columns):
+                column, offset = _name(payload, offset)
+                kind = chr(payload[offset])
+                (length,) = struct.unpack_from("<I", payload, offset + 1)
+                offset += 5
+                if columns is None or column in columns:
+                    values = _decode_column(kind, payload[offset:offset + length], rows)
+                    result.setdefault(column, [None] * total).extend(values)
+                    seen.add(column)
+                offset += length
+            for column in result:
+                if column not in seen:
+                    result[column].extend([None] * rows)
+            total += rows
+        return result
+
+    def rows(self, table, columns=None):
+        """Returns the rows of the table as dicts"""
+        data = self.read(table, columns)
+        if not data:
+            return []
+        names = list(data)
+        return [dict(zip(names, values)) for values in zip(*(data[n] for n in names))]
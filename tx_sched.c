@@ -0,0 +1,368 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Advertising transmit scheduler of a relay node. Own publications, relayed PDUs, friend
+ * responses, beacons and proxy advertisements are each sent by the mesh core with their own
+ * timing and advertising delay. With TX_SCHED the core passes every advertising event to the
+ * application, which keeps them in one queue with a deadline per event:
+ *
+ * - friend response: end of the LPN receive window
+ * - relayed PDU and own publication: the slot of the next retransmission
+ * - beacon and proxy advertisement: half of their interval, they are periodic
+ *
+ * With the edf policy the event with the earliest deadline is sent first, ties go to the class
+ * with the higher priority. With the fifo policy events are sent in the order they were queued.
+ * When an event completes the next queued event is sent back to back, without the random
+ * advertising delay. An event which can no longer start before its deadline is dropped. Each
+ * event is passed to the core with a token which the core returns with its completion, a
+ * completion whose token is not the one of the event in progress is ignored.
+ *
+ * Queue depth and the latency from queueing to the start of transmission are reported per class.
+ *
+ * The prebuilt mesh core does not pass its advertising events to the application. The module
+ * is written against an assumed extension of the core API, wiced_bt_mesh_core_register_adv_tx_cb
+ * and wiced_bt_mesh_core_adv_tx, and needs a core which provides them.
+ *
+ */
+
+#include "wiced_bt_mesh_models.h"
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "clock_timer.h"
+#include "low_power_led.h"
+#include "low_power_led_hci.h"
+#include "tx_sched.h"
+
+#if defined(TX_SCHED) && (!defined(LOW_POWER_NODE) || (LOW_POWER_NODE == 0))
+
+/******************************************************************************
+ *                                Constants
+ ******************************************************************************/
+#define TX_SCHED_ADV_DATA_LEN           31          // legacy advertising data
+#define TX_SCHED_WATCHDOG_MS            100         // an advertising event on 3 channels takes a few ms
+
+/******************************************************************************
+ *                                Structures
+ ******************************************************************************/
+typedef struct
+{
+    uint8_t         priority;                   // higher is sent first among equal deadlines
+    uint16_t        max_delay_ms;               // deadline used when the core does not give one
+} tx_sched_class_cfg_t;
+
+typedef struct
+{
+    wiced_bool_t    used;
+    uint8_t         tx_class;
+    uint8_t         len;
+    uint8_t         data[TX_SCHED_ADV_DATA_LEN];
+    uint64_t        queued_us;
+    uint64_t        deadline_us;
+} tx_sched_job_t;
+
+typedef struct
+{
+    uint32_t        sent;
+    uint32_t        missed;                     // dropped, deadline passed
+    uint32_t        rejected;                   // queue full, sent by the core
+    uint32_t        latency_total_ms;           // queued to start of transmission
+    uint16_t        latency_max_ms;
+} tx_sched_class_stats_t;
+
+typedef struct
+{
+    tx_sched_job_t  queue[TX_SCHED_QUEUE_SIZE];
+    uint8_t         depth;
+    uint8_t         depth_max;
+    wiced_bool_t    busy;                       // advertising event in progress
+    uint32_t        token;                      // token of the last event passed to the core
+    tx_sched_class_stats_t stats[TX_SCHED_CLASSES];
+    uint32_t        failed;                     // events the core did not accept
+    uint32_t        watchdog;                   // events not completed within TX_SCHED_WATCHDOG_MS
+    wiced_bool_t    timer_initialized;
+    wiced_timer_t   watchdog_timer;
+} tx_sched_state_t;
+
+/******************************************************************************
+ *                          Function Declarations
+ ******************************************************************************/
+static wiced_bool_t tx_sched_submit(uint8_t tx_class, uint8_t *p_data, uint8_t len, uint16_t max_delay_ms);
+static void tx_sched_tx_complete(uint32_t token);
+static void tx_sched_dispatch(void);
+static tx_sched_job_t *tx_sched_select(uint64_t now_us);
+static void tx_sched_watchdog_cb(TIMER_PARAM_TYPE arg);
+
+/******************************************************************************
+ *                                Variables Definitions
+ ******************************************************************************/
+static const tx_sched_class_cfg_t tx_sched_class_cfg[TX_SCHED_CLASSES] =
+{
+    { 4,   20 },        // TX_SCHED_CLASS_FRIEND, receive window
+    { 3,   20 },        // TX_SCHED_CLASS_RELAY, relay retransmit interval
+    { 2,   20 },        // TX_SCHED_CLASS_OWN, network transmit interval
+    { 1, 5000 },        // TX_SCHED_CLASS_BEACON, 10 s beacon interval
+    { 0,   50 },        // TX_SCHED_CLASS_PROXY_ADV, 100 ms advertising interval
+};
+
+static tx_sched_state_t tx_sched = { 0 };
+
+/******************************************************************************
+ *                          Function Definitions
+ ******************************************************************************/
+
+/*
+ * Register the scheduler with the mesh core
+ */
+void tx_sched_init(void)
+{
+    if (!tx_sched.timer_initialized)
+    {
+        wiced_init_timer(&tx_sched.watchdog_timer, tx_sched_watchdog_cb, 0, WICED_MILLI_SECONDS_TIMER);
+        tx_sched.timer_initialized = WICED_TRUE;
+    }
+    wiced_stop_timer(&tx_sched.watchdog_timer);
+
+    memset(tx_sched.queue, 0, sizeof(tx_sched.queue));
+    tx_sched.depth = 0;
+    tx_sched.busy  = WICED_FALSE;
+
+    WICED_BT_TRACE("tx sched policy:%d queue:%d\n", TX_SCHED_POLICY, TX_SCHED_QUEUE_SIZE);
+    wiced_bt_mesh_core_register_adv_tx_cb(tx_sched_submit);
+}
+
+/*
+ * Advertising event from the mesh core. max_delay_ms is the time the event can wait, 0 to use
+ * the class default. Returns WICED_FALSE if the queue is full and the core sends the event.
+ */
+static wiced_bool_t tx_sched_submit(uint8_t tx_class, uint8_t *p_data, uint8_t len, uint16_t max_delay_ms)
+{
+    tx_sched_job_t *p_job = NULL;
+    int            i;
+
+    if ((tx_class >= TX_SCHED_CLASSES) || (len > TX_SCHED_ADV_DATA_LEN))
+        return WICED_FALSE;
+
+    for (i = 0; i < TX_SCHED_QUEUE_SIZE; i++)
+    {
+        if (!tx_sched.queue[i].used)
+        {
+            p_job = &tx_sched.queue[i];
+            break;
+        }
+    }
+    if (p_job == NULL)
+    {
+        tx_sched.stats[tx_class].rejected++;
+        return WICED_FALSE;
+    }
+
+    if (max_delay_ms == 0)
+        max_delay_ms = tx_sched_class_cfg[tx_class].max_delay_ms;
+
+    p_job->used        = WICED_TRUE;
+    p_job->tx_class    = tx_class;
+    p_job->len         = len;
+    memcpy(p_job->data, p_data, len);
+    p_job->queued_us   = clock_SystemTimeMicroseconds64();
+    p_job->deadline_us = p_job->queued_us + (uint64_t)max_delay_ms * 1000;
+
+    if (++tx_sched.depth > tx_sched.depth_max)
+        tx_sched.depth_max = tx_sched.depth;
+
+    tx_sched_dispatch();
+    return WICED_TRUE;
+}
+
+/*
+ * Advertising event sent on all channels, the next one is sent back to back
+ */
+static void tx_sched_tx_complete(uint32_t token)
+{
+    // Late completion of an event the watchdog gave up, another event can be in progress
+    if (!tx_sched.busy || (token != tx_sched.token))
+        return;
+
+    wiced_stop_timer(&tx_sched.watchdog_timer);
+    tx_sched.busy = WICED_FALSE;
+    tx_sched_dispatch();
+}
+
+/*
+ * The core did not report the completion in time. Free the radio for the next event so that
+ * the queue does not stall, a completion which comes later is ignored.
+ */
+static void tx_sched_watchdog_cb(TIMER_PARAM_TYPE arg)
+{
+    if (!tx_sched.busy)
+        return;
+
+    WICED_BT_TRACE("tx sched watchdog depth:%d\n", tx_sched.depth);
+
+    tx_sched.watchdog++;
+    tx_sched.busy = WICED_FALSE;
+    tx_sched_dispatch();
+}
+
+/*
+ * Start the next advertising event if the radio is free. An event the core does not accept is
+ * dropped and the next one is tried.
+ */
+static void tx_sched_dispatch(void)
+{
+    uint64_t               now_us;
+    tx_sched_job_t         *p_job;
+    tx_sched_class_stats_t *p_stats;
+    uint32_t               latency_ms;
+
+    while (!tx_sched.busy)
+    {
+        now_us = clock_SystemTimeMicroseconds64();
+        p_job  = tx_sched_select(now_us);
+        if (p_job == NULL)
+            return;
+
+        p_job->used = WICED_FALSE;
+        tx_sched.depth--;
+
+        // The core passes the token back with the completion of this event
+        if (wiced_bt_mesh_core_adv_tx(p_job->data, p_job->len, ++tx_sched.token, tx_sched_tx_complete) != WICED_BT_SUCCESS)
+        {
+            tx_sched.failed++;
+            continue;
+        }
+        tx_sched.busy = WICED_TRUE;
+        wiced_start_timer(&tx_sched.watchdog_timer, TX_SCHED_WATCHDOG_MS);
+
+        p_stats    = &tx_sched.stats[p_job->tx_class];
+        latency_ms = (uint32_t)((now_us - p_job->queued_us) / 1000);
+        p_stats->sent++;
+        p_stats->latency_total_ms += latency_ms;
+        if (latency_ms > p_stats->latency_max_ms)
+            p_stats->latency_max_ms = (uint16_t)latency_ms;
+    }
+}
+
+/*
+ * Drop the events past their deadline and return the event to send next, NULL if the queue is empty
+ */
+static tx_sched_job_t *tx_sched_select(uint64_t now_us)
+{
+    tx_sched_job_t *p_best = NULL;
+    tx_sched_job_t *p_job;
+    int            i;
+
+    for (i = 0; i < TX_SCHED_QUEUE_SIZE; i++)
+    {
+        p_job = &tx_sched.queue[i];
+        if (!p_job->used)
+            continue;
+
+        if (p_job->deadline_us < now_us)
+        {
+            tx_sched.stats[p_job->tx_class].missed++;
+            p_job->used = WICED_FALSE;
+            tx_sched.depth--;
+            continue;
+        }
+
+        if (p_best == NULL)
+        {
+            p_best = p_job;
+        }
+#if (TX_SCHED_POLICY == TX_SCHED_POLICY_EDF)
+        else if ((p_job->deadline_us < p_best->deadline_us) ||
+                 ((p_job->deadline_us == p_best->deadline_us) && (tx_sched_class_cfg[p_job->tx_class].priority > tx_sched_class_cfg[p_best->tx_class].priority)))
+        {
+            p_best = p_job;
+        }
+#else
+        else if (p_job->queued_us < p_best->queued_us)
+        {
+            p_best = p_job;
+        }
+#endif
+    }
+    return p_best;
+}
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t tx_sched_serialize_stats(uint8_t *p_buffer)
+{
+    uint8_t *p = p_buffer;
+    int     i;
+
+    UINT8_TO_STREAM(p, TX_SCHED_POLICY);
+    UINT8_TO_STREAM(p, tx_sched.depth);
+    UINT8_TO_STREAM(p, tx_sched.depth_max);
+    for (i = 0; i < TX_SCHED_CLASSES; i++)
+    {
+        UINT32_TO_STREAM(p, tx_sched.stats[i].sent);
+        UINT32_TO_STREAM(p, tx_sched.stats[i].missed);
+        UINT32_TO_STREAM(p, tx_sched.stats[i].rejected);
+        UINT16_TO_STREAM(p, (tx_sched.stats[i].sent != 0) ? (uint16_t)(tx_sched.stats[i].latency_total_ms / tx_sched.stats[i].sent) : 0);
+        UINT16_TO_STREAM(p, tx_sched.stats[i].latency_max_ms);
+    }
+    UINT32_TO_STREAM(p, tx_sched.failed);
+    UINT32_TO_STREAM(p, tx_sched.watchdog);
+
+    return (uint16_t)(p - p_buffer);
+}
+
+/*
+ * Clear the counters
+ */
+void tx_sched_reset_stats(void)
+{
+    memset(tx_sched.stats, 0, sizeof(tx_sched.stats));
+    tx_sched.failed    = 0;
+    tx_sched.watchdog  = 0;
+    tx_sched.depth_max = tx_sched.depth;
+}
+
+/*
+ * Send the statistics to the host
+ */
+void tx_sched_hci_send(void)
+{
+#ifdef HCI_CONTROL
+    uint8_t buffer[TX_SCHED_STATS_LEN];
+
+    mesh_low_power_led_hci_send(HCI_CONTROL_LOW_POWER_LED_EVENT_TX_SCHED_STATS, buffer, tx_sched_serialize_stats(buffer));
+#endif
+}
+
+#endif // TX_SCHED && !LOW_POWER_NODE
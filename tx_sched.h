@@ -0,0 +1,99 @@
+/*
+ * Copyright 2016-2023, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ * Advertising transmit scheduler API definition
+ */
+
+#ifndef __TX_SCHED__H
+#define __TX_SCHED__H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TX_SCHED_POLICY_FIFO                0       // events are sent in the order they were queued
+#define TX_SCHED_POLICY_EDF                 1       // earliest deadline first, then class priority
+
+#ifndef TX_SCHED_POLICY
+#define TX_SCHED_POLICY                     TX_SCHED_POLICY_EDF
+#endif
+
+#ifndef TX_SCHED_QUEUE_SIZE
+#define TX_SCHED_QUEUE_SIZE                 16
+#endif
+
+/*
+ * Classes of advertising events, passed by the mesh core
+ */
+#define TX_SCHED_CLASS_FRIEND               0       // friend response to a Poll
+#define TX_SCHED_CLASS_RELAY                1       // relayed network PDU
+#define TX_SCHED_CLASS_OWN                  2       // network PDU originated by the node
+#define TX_SCHED_CLASS_BEACON               3       // secure network beacon
+#define TX_SCHED_CLASS_PROXY_ADV            4       // Mesh Proxy Service advertisement
+#define TX_SCHED_CLASSES                    5
+
+/*
+ * Serialized statistics, little endian
+ *   policy (1), queue depth (1), maximum queue depth (1), then for each class: events sent (4),
+ *   dropped after the deadline (4), rejected because the queue was full (4),
+ *   mean and maximum latency in ms (2 each), then events the core did not accept (4) and
+ *   events not completed before the watchdog expired (4)
+ */
+#define TX_SCHED_STATS_LEN                  (1 + 1 + 1 + TX_SCHED_CLASSES * (4 + 4 + 4 + 2 + 2) + 4 + 4)
+
+/*
+ * Register the scheduler with the mesh core
+ */
+void tx_sched_init(void);
+
+/*
+ * Serialize the statistics. Returns length.
+ */
+uint16_t tx_sched_serialize_stats(uint8_t *p_buffer);
+
+/*
+ * Clear the counters
+ */
+void tx_sched_reset_stats(void);
+
+/*
+ * Send the statistics to the host
+ */
+void tx_sched_hci_send(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif